@@ -0,0 +1,68 @@
+#include "decimator.h"
+
+#include <cmath>
+
+Decimator::Decimator(int factor)
+    : factor_(factor < 1 ? 1 : factor), count_(0)
+{
+    // Blackman 窗 sinc，直流增益归一化为1。16N+1 阶、截止 0.33/N 时，
+    // f >= 0.5/N(输出奈奎斯特频率及以上，会混叠进输出)衰减 >= 70dB，0.2/N 以内起伏 < 0.1dB
+    int length = 16 * factor_ + 1;
+    int center = length / 2;
+    double fc = 0.33 / factor_;
+    double sum = 0;
+    taps_.resize(length);
+    for (int n = 0; n < length; ++n)
+    {
+        double x = n - center;
+        double sinc = x == 0 ? 2 * fc : sin(2 * M_PI * fc * x) / (M_PI * x);
+        double window = 0.42 - 0.5 * cos(2 * M_PI * n / (length - 1)) + 0.08 * cos(4 * M_PI * n / (length - 1));
+        taps_[n] = sinc * window;
+        sum += taps_[n];
+    }
+    for (int n = 0; n < length; ++n)
+        taps_[n] /= sum;
+}
+
+bool Decimator::push(const ImuSample &s, ImuSample &out)
+{
+    window_.push_back(s);
+    if (window_.size() > taps_.size())
+        window_.pop_front();
+    if (++count_ < factor_ || window_.size() < taps_.size())
+        return false;
+    count_ = 0;
+
+    // 只在输出时刻计算卷积
+    int center = taps_.size() / 2;
+    out.t = window_[center].t;
+    out.w.setZero();
+    out.a.setZero();
+    for (size_t n = 0; n < taps_.size(); ++n)
+    {
+        out.w += taps_[n] * window_[n].w;
+        out.a += taps_[n] * window_[n].a;
+    }
+
+    // 姿态取以 center 为中心的 2*(factor/2)+1 个采样，factor 为偶数时两端各算半个权重，
+    // 总权重为 factor 且与FIR一样对称于 out.t。逐个SLERP加权平均，先统一到同一半球
+    int half = factor_ / 2;
+    double total = 0;
+    for (int k = -half; k <= half; ++k)
+    {
+        double weight = factor_ % 2 == 0 && (k == -half || k == half) ? 0.5 : 1.0;
+        Eigen::Quaterniond q = window_[center + k].q;
+        if (total == 0)
+        {
+            out.q = q;
+            total = weight;
+            continue;
+        }
+        if (q.dot(out.q) < 0)
+            q.coeffs() = -q.coeffs();
+        total += weight;
+        out.q = out.q.slerp(weight / total, q);
+    }
+    out.q.normalize();
+    return true;
+}
@@ -0,0 +1,29 @@
+#ifndef SANCHI_AMOV_DECIMATOR_H
+#define SANCHI_AMOV_DECIMATOR_H
+
+#include <deque>
+#include <vector>
+#include "imu_sample.h"
+
+// 按整数倍抽取IMU数据: 角速度和加速度先经 16*factor+1 阶加窗sinc低通，
+// 0.5/factor 及以上衰减 >= 70dB，0.2/factor 以内平坦(< 0.1dB)，-3dB 点约 0.3/factor；
+// 姿态取以FIR中心为中心、总权重 factor 的SLERP平均(偶数时两端各半个)，输出时间戳为FIR中心采样的时刻。
+// 群延时 8*factor 个采样，例如 100Hz、factor 10 时输出比最新采样晚 0.8 秒
+class Decimator
+{
+public:
+    explicit Decimator(int factor);
+
+    int factor() const { return factor_; }
+
+    // 每个输入采样调用一次，每 factor 个采样产生一个输出并返回 true
+    bool push(const ImuSample &s, ImuSample &out);
+
+private:
+    int factor_;
+    int count_;
+    std::vector<double> taps_;
+    ImuSampleDeque window_;
+};
+
+#endif
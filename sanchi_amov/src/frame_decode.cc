@@ -0,0 +1,154 @@
+#include "frame_decode.h"
+
+#include <math.h>
+#include "frame_unpack.h"
+
+// 各型号的字段块，div 为除数，取负即该轴取反
+// 100S: A1 欧拉角; A2 加速度、角速度、磁场
+static const FieldBlock blk_100s_euler = {4, 3, FIELD_I16_BE, {10.0f, 10.0f, 10.0f}};
+static const FieldBlock blk_100s_imu = {4, 9, FIELD_I16_BE,
+                                        {16384.0f, 16384.0f, 16384.0f, 32.8f, 32.8f, 32.8f, 1.0f, 1.0f, 1.0f}};
+// 100D2: 航向(取反)、横滚、俯仰、加速度、角速度、磁场
+static const FieldBlock blk_100d2 = {3, 12, FIELD_I16_BE,
+                                     {-10.0f, 10.0f, 10.0f, 16384.0f, 16384.0f, 16384.0f,
+                                      32.8f, 32.8f, 32.8f, 1.0f, 1.0f, 1.0f}};
+// 200A/300A: 加速度、角速度、磁场、欧拉角
+static const FieldBlock blk_200a = {3, 12, FIELD_F32_LE,
+                                    {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f}};
+static const FieldBlock blk_300a = {3, 12, FIELD_F32_LE,
+                                    {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, -1.0f, -1.0f}};
+// 200S: 加速度、角速度(两者Y取反)、温度，低位在前
+static const FieldBlock blk_200s_imu = {3, 7, FIELD_I16_LE, {-1.0f, 1.0f, 1.0f, -1.0f, 1.0f, 1.0f, 1.0f}};
+// 200S: 俯仰、横滚、航向
+static const FieldBlock blk_200s_euler = {17, 3, FIELD_F32_LE, {-1.0f, 1.0f, -1.0f}};
+// 200S: 磁场(Y取反)
+static const FieldBlock blk_200s_mag = {70, 3, FIELD_I16_LE, {-1.0f, 1.0f, 1.0f}};
+
+// 绕Z,Y,X
+static Eigen::Quaterniond euler_zyx(const Eigen::Vector3d &ea0)
+{
+    Eigen::Matrix3d R;
+    R = Eigen::AngleAxisd(ea0[0], ::Eigen::Vector3d::UnitZ()) * Eigen::AngleAxisd(ea0[1], ::Eigen::Vector3d::UnitY()) * Eigen::AngleAxisd(ea0[2], ::Eigen::Vector3d::UnitX());
+    Eigen::Quaterniond q;
+    q = R;
+    return q;
+}
+
+void decode_100s_euler(const uint8_t *frame, int len, ImuFrame &out)
+{
+    float f[16];
+    unpack_fields(frame, len, blk_100s_euler, f);
+    out.q = euler_zyx(Eigen::Vector3d(f[0] * M_PI / 180.0,
+                                      f[1] * M_PI / 180.0,
+                                      f[2] * M_PI / 180.0));
+}
+
+void decode_100s_imu(const uint8_t *frame, int len, ImuFrame &out)
+{
+    float f[16];
+    unpack_fields(frame, len, blk_100s_imu, f);
+    out.w = Eigen::Vector3d(f[3], f[4], f[5]);
+    out.a = Eigen::Vector3d(f[0] * 9.81, f[1] * 9.81, f[2] * 9.81);
+    out.mag = Eigen::Vector3d(f[6], f[7], f[8]);
+}
+
+void decode_100s_gps(const uint8_t *frame, double &latitude, double &longitude, double &altitude)
+{
+    // 纬度、经度为高位在前的 int32，单位 1e-6 度；frame[18] 为南北/东西半球
+    latitude = load_i32_be(frame + 4) * 1e-6;
+    longitude = load_i32_be(frame + 8) * 1e-6;
+    if (frame[18] == 0x12)
+    {
+        latitude = -latitude;
+    }
+    else if (frame[18] == 0x11)
+    {
+        latitude = -latitude;
+        longitude = -longitude;
+    }
+    else if (frame[18] == 0x21)
+    {
+        longitude = -longitude;
+    }
+    // 海拔沿用原驱动的解法: 读 16..19 四个字节(与半球标志、校验和重叠)，两半以8位移位合并。
+    // 协议里海拔的格式尚未确认，确认之前保持输出不变
+    int64_t high = (frame[16] << 8) | frame[17];
+    int64_t low = (frame[18] << 8) | frame[19];
+    altitude = (double)((high << 8) | low) / 10.0f;
+}
+
+void decode_100d2(const uint8_t *frame, int len, ImuFrame &out)
+{
+    float f[16];
+    unpack_fields(frame, len, blk_100d2, f);
+    out.q = euler_zyx(Eigen::Vector3d(f[0] * M_PI / 180.0,
+                                      f[2] * M_PI / 180.0,
+                                      f[1] * M_PI / 180.0));
+    out.w = Eigen::Vector3d(f[6], f[7], f[8]);
+    out.a = Eigen::Vector3d(f[3] * 9.81, f[4] * 9.81, f[5] * 9.81);
+    out.mag = Eigen::Vector3d(f[9], f[10], f[11]);
+}
+
+// 200A/300A 字段相同，只有欧拉角顺序和符号不同
+static void decode_a(const float *f, ImuFrame &out)
+{
+    out.w = Eigen::Vector3d(f[3] * M_PI / 180, f[4] * M_PI / 180, f[5] * M_PI / 180);
+    out.a = Eigen::Vector3d(f[0] * 1e-3 * 9.81, f[1] * 1e-3 * 9.81, f[2] * 1e-3 * 9.81);
+    out.mag = Eigen::Vector3d(f[6], f[7], f[8]);
+}
+
+void decode_200a(const uint8_t *frame, int len, ImuFrame &out)
+{
+    float f[16];
+    unpack_fields(frame, len, blk_200a, f);
+    out.q = euler_zyx(Eigen::Vector3d(f[9] * M_PI / 180.0,
+                                      f[10] * M_PI / 180.0,
+                                      f[11] * M_PI / 180.0));
+    decode_a(f, out);
+}
+
+void decode_300a(const uint8_t *frame, int len, ImuFrame &out)
+{
+    float f[16];
+    unpack_fields(frame, len, blk_300a, f);
+    Eigen::Vector3d ea0(f[9] * M_PI / 180.0,
+                        f[10] * M_PI / 180.0,
+                        f[11] * M_PI / 180.0);
+    // 绕Y,X,Z
+    Eigen::Matrix3d R;
+    R = Eigen::AngleAxisd(ea0[0], ::Eigen::Vector3d::UnitY()) * Eigen::AngleAxisd(ea0[1], ::Eigen::Vector3d::UnitX()) * Eigen::AngleAxisd(ea0[2], ::Eigen::Vector3d::UnitZ());
+    out.q = R;
+    decode_a(f, out);
+}
+
+void decode_200s(const uint8_t *frame, int len, ImuFrame &out)
+{
+    float e[16];
+    unpack_fields(frame, len, blk_200s_euler, e);
+    out.q = euler_zyx(Eigen::Vector3d(e[2] * M_PI / 180.0,
+                                      e[0] * M_PI / 180.0,
+                                      e[1] * M_PI / 180.0));
+
+    // 原始顺序为 Y X Z，转到ROS坐标系
+    float f[16];
+    unpack_fields(frame, len, blk_200s_imu, f);
+    out.w = Eigen::Vector3d(f[4] * 0.02 * M_PI / 180,
+                            f[3] * 0.02 * M_PI / 180,
+                            f[5] * 0.02 * M_PI / 180);
+    out.a = Eigen::Vector3d(f[1] * 0.5 * 1e-3 * 9.81,
+                            f[0] * 0.5 * 1e-3 * 9.81,
+                            f[2] * 0.5 * 1e-3 * 9.81);
+
+    // 温度 f[6] * 0.01
+
+    unpack_fields(frame, len, blk_200s_mag, f);
+    out.mag = Eigen::Vector3d(f[1], f[0], f[2]);
+}
+
+void decode_200s_gps(const uint8_t *frame, double &latitude, double &longitude, double &altitude)
+{
+    // 这个应该有问题，但是没有上机测试
+    latitude = load_f64(frame + 43);
+    longitude = load_f64(frame + 35);
+    altitude = load_f32(frame + 51);
+}
@@ -0,0 +1,27 @@
+#ifndef SANCHI_AMOV_FRAME_DECODE_H
+#define SANCHI_AMOV_FRAME_DECODE_H
+
+#include <stdint.h>
+#include <eigen3/Eigen/Geometry>
+
+// 一帧解出的量，已换到ROS坐标系和单位
+struct ImuFrame
+{
+    Eigen::Quaterniond q;
+    Eigen::Vector3d w; // rad/s
+    Eigen::Vector3d a; // m/s^2
+    Eigen::Vector3d mag;
+};
+
+// frame 指向帧头，len 为 frame 起可读的字节数(见 unpack_fields)，校验由调用者完成
+// 100S 分帧输出: A1 只填 q，A2 填 w a mag
+void decode_100s_euler(const uint8_t *frame, int len, ImuFrame &out);
+void decode_100s_imu(const uint8_t *frame, int len, ImuFrame &out);
+void decode_100s_gps(const uint8_t *frame, double &latitude, double &longitude, double &altitude);
+void decode_100d2(const uint8_t *frame, int len, ImuFrame &out);
+void decode_200a(const uint8_t *frame, int len, ImuFrame &out);
+void decode_300a(const uint8_t *frame, int len, ImuFrame &out);
+void decode_200s(const uint8_t *frame, int len, ImuFrame &out);
+void decode_200s_gps(const uint8_t *frame, double &latitude, double &longitude, double &altitude);
+
+#endif
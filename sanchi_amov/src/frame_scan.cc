@@ -0,0 +1,148 @@
+#include "frame_scan.h"
+
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SANCHI_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+static int find_header_scalar(const uint8_t *buf, int from, int len, uint8_t h0, uint8_t h1)
+{
+    for (int i = from; i < len - 1; ++i)
+    {
+        if (buf[i] == h0 && buf[i + 1] == h1)
+            return i;
+    }
+    return len;
+}
+
+static uint32_t byte_sum_scalar(const uint8_t *buf, int len)
+{
+    uint32_t sum = 0;
+    for (int i = 0; i < len; ++i)
+        sum += (uint32_t)buf[i];
+    return sum;
+}
+
+#ifdef SANCHI_X86_KERNELS
+
+// 每次比较16个起始位置: buf[i..i+15] == h0 且 buf[i+1..i+16] == h1
+__attribute__((target("sse2"))) static int find_header_sse2(const uint8_t *buf, int from, int len, uint8_t h0, uint8_t h1)
+{
+    const __m128i v0 = _mm_set1_epi8((char)h0);
+    const __m128i v1 = _mm_set1_epi8((char)h1);
+    int i = from;
+    for (; i + 17 <= len; i += 16)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *)(buf + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(buf + i + 1));
+        int mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, v0), _mm_cmpeq_epi8(b, v1)));
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+    return find_header_scalar(buf, i, len, h0, h1);
+}
+
+__attribute__((target("sse2"))) static uint32_t byte_sum_sse2(const uint8_t *buf, int len)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc = zero;
+    int i = 0;
+    for (; i + 16 <= len; i += 16)
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(_mm_loadu_si128((const __m128i *)(buf + i)), zero));
+    uint32_t sum = (uint32_t)_mm_cvtsi128_si32(acc) + (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(acc, 8));
+    return sum + byte_sum_scalar(buf + i, len - i);
+}
+
+__attribute__((target("avx2"))) static int find_header_avx2(const uint8_t *buf, int from, int len, uint8_t h0, uint8_t h1)
+{
+    const __m256i v0 = _mm256_set1_epi8((char)h0);
+    const __m256i v1 = _mm256_set1_epi8((char)h1);
+    int i = from;
+    for (; i + 33 <= len; i += 32)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(buf + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(buf + i + 1));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, v0), _mm256_cmpeq_epi8(b, v1)));
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+    if (i + 17 <= len)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *)(buf + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(buf + i + 1));
+        int mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, _mm256_castsi256_si128(v0)),
+                                                   _mm_cmpeq_epi8(b, _mm256_castsi256_si128(v1))));
+        if (mask)
+            return i + __builtin_ctz(mask);
+        i += 16;
+    }
+    for (; i < len - 1; ++i)
+    {
+        if (buf[i] == h0 && buf[i + 1] == h1)
+            return i;
+    }
+    return len;
+}
+
+__attribute__((target("avx2"))) static uint32_t byte_sum_avx2(const uint8_t *buf, int len)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i acc = zero;
+    int i = 0;
+    for (; i + 32 <= len; i += 32)
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_loadu_si256((const __m256i *)(buf + i)), zero));
+    __m128i half = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    if (i + 16 <= len)
+    {
+        half = _mm_add_epi64(half, _mm_sad_epu8(_mm_loadu_si128((const __m128i *)(buf + i)), _mm_setzero_si128()));
+        i += 16;
+    }
+    uint32_t sum = (uint32_t)_mm_cvtsi128_si32(half) + (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(half, 8));
+    for (; i < len; ++i)
+        sum += (uint32_t)buf[i];
+    return sum;
+}
+
+#endif
+
+static int (*find_header_impl)(const uint8_t *, int, int, uint8_t, uint8_t) = find_header_scalar;
+static uint32_t (*byte_sum_impl)(const uint8_t *, int) = byte_sum_scalar;
+
+int find_header(const uint8_t *buf, int from, int len, uint8_t h0, uint8_t h1)
+{
+    return find_header_impl(buf, from, len, h0, h1);
+}
+
+uint32_t byte_sum(const uint8_t *buf, int len)
+{
+    return byte_sum_impl(buf, len);
+}
+
+const char *select_frame_kernels(const char *name)
+{
+    bool automatic = strcmp(name, "auto") == 0;
+#ifdef SANCHI_X86_KERNELS
+    __builtin_cpu_init();
+    if ((automatic || strcmp(name, "avx2") == 0) && __builtin_cpu_supports("avx2"))
+    {
+        find_header_impl = find_header_avx2;
+        byte_sum_impl = byte_sum_avx2;
+        return "avx2";
+    }
+    if ((automatic || strcmp(name, "sse2") == 0) && __builtin_cpu_supports("sse2"))
+    {
+        find_header_impl = find_header_sse2;
+        byte_sum_impl = byte_sum_sse2;
+        return "sse2";
+    }
+#endif
+    if (automatic || strcmp(name, "scalar") == 0)
+    {
+        find_header_impl = find_header_scalar;
+        byte_sum_impl = byte_sum_scalar;
+        return "scalar";
+    }
+    return 0;
+}
@@ -0,0 +1,16 @@
+#ifndef SANCHI_AMOV_FRAME_SCAN_H
+#define SANCHI_AMOV_FRAME_SCAN_H
+
+#include <stdint.h>
+
+// 在 buf[from, len) 中查找帧头 h0 h1，返回帧头下标，找不到返回 len
+int find_header(const uint8_t *buf, int from, int len, uint8_t h0, uint8_t h1);
+
+// buf[0, len) 的字节累加和，校验用
+uint32_t byte_sum(const uint8_t *buf, int len);
+
+// 选择帧头查找/校验的实现: "auto", "scalar", "sse2", "avx2"
+// auto 按运行时CPU支持选择，返回实际使用的实现名，不支持时返回 0
+const char *select_frame_kernels(const char *name);
+
+#endif
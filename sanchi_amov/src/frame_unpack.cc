@@ -0,0 +1,126 @@
+#include "frame_unpack.h"
+
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SANCHI_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+// 逐字段读取，不会越过最后一个字段，用不到 len
+static void unpack_fields_scalar(const uint8_t *frame, int /*len*/, const FieldBlock &block, float *out)
+{
+    const uint8_t *a = frame + block.offset;
+    for (int i = 0; i < block.count; ++i)
+    {
+        float raw;
+        if (block.type == FIELD_F32_LE)
+        {
+            memcpy(&raw, a + 4 * i, 4);
+        }
+        else
+        {
+            const uint8_t *b = a + 2 * i;
+            int16_t v = block.type == FIELD_I16_BE ? (int16_t)((b[0] << 8) | b[1])
+                                                   : (int16_t)((b[1] << 8) | b[0]);
+            raw = (float)v;
+        }
+        out[i] = raw / block.div[i];
+    }
+}
+
+#ifdef SANCHI_X86_KERNELS
+
+// 一次取整块，字节交换、符号扩展后除以 div 向量；帧后余量不足一个向量时先拷到清零的缓冲区，
+// 多出的通道不会读到未初始化的字节
+__attribute__((target("sse2"))) static __m128 load_div_sse2(const float *div)
+{
+    // 未用到的通道 div 为0，换成1
+    const __m128 zero = _mm_setzero_ps();
+    __m128 d = _mm_loadu_ps(div);
+    return _mm_or_ps(d, _mm_and_ps(_mm_cmpeq_ps(d, zero), _mm_set1_ps(1.0f)));
+}
+
+__attribute__((target("sse2"))) static void unpack_fields_sse2(const uint8_t *frame, int len, const FieldBlock &block, float *out)
+{
+    alignas(16) uint8_t stage[64];
+    const uint8_t *a = frame + block.offset;
+
+    if (block.type == FIELD_F32_LE)
+    {
+        int bytes = (block.count + 3) / 4 * 16;
+        if (block.offset + bytes > len)
+        {
+            memset(stage, 0, bytes);
+            memcpy(stage, a, 4 * block.count);
+            a = stage;
+        }
+        for (int i = 0; i < block.count; i += 4)
+        {
+            __m128 v = _mm_loadu_ps((const float *)(a + 4 * i));
+            _mm_storeu_ps(out + i, _mm_div_ps(v, load_div_sse2(block.div + i)));
+        }
+    }
+    else
+    {
+        int bytes = (block.count + 7) / 8 * 16;
+        if (block.offset + bytes > len)
+        {
+            memset(stage, 0, bytes);
+            memcpy(stage, a, 2 * block.count);
+            a = stage;
+        }
+        for (int i = 0; i < block.count; i += 8)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i *)(a + 2 * i));
+            if (block.type == FIELD_I16_BE)
+                v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+            __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+            __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+            _mm_storeu_ps(out + i, _mm_div_ps(_mm_cvtepi32_ps(lo), load_div_sse2(block.div + i)));
+            _mm_storeu_ps(out + i + 4, _mm_div_ps(_mm_cvtepi32_ps(hi), load_div_sse2(block.div + i + 4)));
+        }
+    }
+}
+
+#endif
+
+static void (*unpack_fields_impl)(const uint8_t *, int, const FieldBlock &, float *) = unpack_fields_scalar;
+
+void unpack_fields(const uint8_t *frame, int len, const FieldBlock &block, float *out)
+{
+    unpack_fields_impl(frame, len, block, out);
+}
+
+float load_f32(const uint8_t *a)
+{
+    float f;
+    memcpy(&f, a, 4);
+    return f;
+}
+
+double load_f64(const uint8_t *a)
+{
+    double d;
+    memcpy(&d, a, 8);
+    return d;
+}
+
+int32_t load_i32_be(const uint8_t *a)
+{
+    return (int32_t)(((uint32_t)a[0] << 24) | ((uint32_t)a[1] << 16) | ((uint32_t)a[2] << 8) | a[3]);
+}
+
+const char *select_unpack_kernels(const char *name)
+{
+#ifdef SANCHI_X86_KERNELS
+    __builtin_cpu_init();
+    if (strcmp(name, "scalar") != 0 && __builtin_cpu_supports("sse2"))
+    {
+        unpack_fields_impl = unpack_fields_sse2;
+        return "sse2";
+    }
+#endif
+    unpack_fields_impl = unpack_fields_scalar;
+    return "scalar";
+}
@@ -0,0 +1,34 @@
+#ifndef SANCHI_AMOV_FRAME_UNPACK_H
+#define SANCHI_AMOV_FRAME_UNPACK_H
+
+#include <stdint.h>
+
+enum FieldType
+{
+    FIELD_I16_BE, // int16，高位在前
+    FIELD_I16_LE, // int16，低位在前
+    FIELD_F32_LE  // IEEE754 float，低位在前
+};
+
+// 帧内一段连续的同类型字段，最多16个
+// out[i] = raw[i] / div[i]，div 的符号即该轴的符号(取反是精确的)
+struct FieldBlock
+{
+    int offset;
+    int count;
+    FieldType type;
+    float div[16];
+};
+
+// len 为 frame 起可读的字节数，out 至少16个
+void unpack_fields(const uint8_t *frame, int len, const FieldBlock &block, float *out);
+
+float load_f32(const uint8_t *a);
+double load_f64(const uint8_t *a);
+// 高位在前的有符号整数
+int32_t load_i32_be(const uint8_t *a);
+
+// 与 select_frame_kernels 相同的名字，"scalar" 以外在支持时使用SSE2
+const char *select_unpack_kernels(const char *name);
+
+#endif
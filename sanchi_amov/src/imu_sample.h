@@ -0,0 +1,22 @@
+#ifndef SANCHI_AMOV_IMU_SAMPLE_H
+#define SANCHI_AMOV_IMU_SAMPLE_H
+
+#include <deque>
+#include <vector>
+#include <eigen3/Eigen/Geometry>
+
+struct ImuSample
+{
+    double t;
+    Eigen::Quaterniond q;
+    Eigen::Vector3d w; // rad/s
+    Eigen::Vector3d a; // m/s^2
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+// Quaterniond 是定长可向量化类型，开 AVX 时要求32字节对齐，标准容器须用 aligned_allocator
+typedef std::deque<ImuSample, Eigen::aligned_allocator<ImuSample> > ImuSampleDeque;
+typedef std::vector<ImuSample, Eigen::aligned_allocator<ImuSample> > ImuSampleVector;
+
+#endif
@@ -0,0 +1,130 @@
+#include "ins_sync.h"
+
+#include <algorithm>
+#include <vector>
+
+// 没有GPS时最多保留的IMU采样数
+static const size_t max_history = 2048;
+
+// 旋转矢量转四元数
+static Eigen::Quaterniond exp_map(const Eigen::Vector3d &phi)
+{
+    double angle = phi.norm();
+    if (angle < 1e-12)
+        return Eigen::Quaterniond::Identity();
+    return Eigen::Quaterniond(Eigen::AngleAxisd(angle, phi / angle));
+}
+
+InsSync::InsSync(double gps_delay, double max_interval)
+    : gps_delay_(gps_delay), max_interval_(max_interval), has_epoch_(false), last_epoch_(0),
+      last_lat_(0), last_lon_(0), last_alt_(0)
+{
+}
+
+ImuSample InsSync::interpolate(double t) const
+{
+    if (t <= history_.front().t)
+        return history_.front();
+    if (t >= history_.back().t)
+        return history_.back();
+
+    size_t i = 1;
+    while (history_[i].t < t)
+        ++i;
+    const ImuSample &s0 = history_[i - 1], &s1 = history_[i];
+    double alpha = (t - s0.t) / (s1.t - s0.t);
+
+    ImuSample s;
+    s.t = t;
+    s.q = s0.q.slerp(alpha, s1.q);
+    s.w = s0.w + alpha * (s1.w - s0.w);
+    s.a = s0.a + alpha * (s1.a - s0.a);
+    return s;
+}
+
+// 中点法积分 [t0, t1] 上的角速度和比力，端点用插值采样
+void InsSync::integrate(double t0, double t1, Eigen::Vector3d &dv, Eigen::Vector3d &dtheta) const
+{
+    ImuSampleVector points;
+    points.push_back(interpolate(t0));
+    for (size_t i = 0; i < history_.size(); ++i)
+    {
+        if (history_[i].t > t0 && history_[i].t < t1)
+            points.push_back(history_[i]);
+    }
+    points.push_back(interpolate(t1));
+
+    Eigen::Quaterniond dR = Eigen::Quaterniond::Identity();
+    dv.setZero();
+    for (size_t i = 1; i < points.size(); ++i)
+    {
+        double dt = points[i].t - points[i - 1].t;
+        if (dt <= 0)
+            continue;
+        Eigen::Vector3d w = 0.5 * (points[i - 1].w + points[i].w);
+        Eigen::Vector3d a = 0.5 * (points[i - 1].a + points[i].a);
+        // 比力按半步处的姿态转到起始机体系
+        dv += (dR * exp_map(0.5 * w * dt)) * a * dt;
+        dR = (dR * exp_map(w * dt)).normalized();
+    }
+    Eigen::AngleAxisd aa(dR);
+    dtheta = aa.angle() * aa.axis();
+}
+
+// 只保留上一历元之前的一个采样供插值，之后的采样下一历元积分要用，不能丢；
+// 超过 max_history 时只能丢掉，增量已无法算出，下一历元从零重新开始
+void InsSync::trim()
+{
+    if (has_epoch_)
+    {
+        while (history_.size() > 2 && history_[1].t <= last_epoch_)
+            history_.pop_front();
+    }
+    if (history_.size() > max_history)
+    {
+        has_epoch_ = false;
+        while (history_.size() > max_history)
+            history_.pop_front();
+    }
+}
+
+bool InsSync::push(const ImuSample &s, double latitude, double longitude, double altitude, InsState &out)
+{
+    history_.push_back(s);
+
+    double epoch = std::max(s.t - gps_delay_, history_.front().t);
+    bool fix = latitude != 0 || longitude != 0;
+    bool moved = latitude != last_lat_ || longitude != last_lon_ || altitude != last_alt_;
+    bool due = has_epoch_ && epoch - last_epoch_ >= max_interval_;
+    if (!fix || (has_epoch_ && !moved && !due))
+    {
+        trim();
+        return false;
+    }
+    last_lat_ = latitude;
+    last_lon_ = longitude;
+    last_alt_ = altitude;
+
+    out.t = epoch;
+    out.repeated = !moved;
+    out.latitude = latitude;
+    out.longitude = longitude;
+    out.altitude = altitude;
+    out.imu = interpolate(epoch);
+    if (has_epoch_ && epoch > last_epoch_)
+    {
+        integrate(last_epoch_, epoch, out.delta_velocity, out.delta_angle);
+        out.delta_time = epoch - last_epoch_;
+    }
+    else
+    {
+        out.delta_velocity.setZero();
+        out.delta_angle.setZero();
+        out.delta_time = 0;
+    }
+
+    has_epoch_ = true;
+    last_epoch_ = epoch;
+    trim();
+    return true;
+}
@@ -0,0 +1,46 @@
+#ifndef SANCHI_AMOV_INS_SYNC_H
+#define SANCHI_AMOV_INS_SYNC_H
+
+#include <deque>
+#include "imu_sample.h"
+
+// GPS 历元上的位置、插值到该时刻的IMU状态，以及上一历元以来的预积分增量(机体系)
+struct InsState
+{
+    double t;
+    double latitude, longitude, altitude;
+    bool repeated; // 位置未更新的补发历元
+    ImuSample imu;
+    Eigen::Vector3d delta_velocity;
+    Eigen::Vector3d delta_angle;
+    double delta_time;
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+// 200S 同一帧里同时有IMU和GPS，GPS 数值变化即为新历元；静止时位置不变，
+// 距上一历元 max_interval 秒后用当前位置补一个历元(repeated)。max_interval 要明显
+// 长于GPS更新周期，否则运动中GPS稍有抖动就会插入带旧位置的历元。
+// 历元时刻 = 帧时刻 - gps_delay，IMU 在该时刻线性插值(姿态SLERP)
+class InsSync
+{
+public:
+    explicit InsSync(double gps_delay = 0.0, double max_interval = 5.0);
+
+    // 每帧调用一次，出现新历元时返回 true 并填写 out
+    bool push(const ImuSample &s, double latitude, double longitude, double altitude, InsState &out);
+
+private:
+    ImuSample interpolate(double t) const;
+    void integrate(double t0, double t1, Eigen::Vector3d &dv, Eigen::Vector3d &dtheta) const;
+    void trim();
+
+    double gps_delay_;
+    double max_interval_;
+    ImuSampleDeque history_;
+    bool has_epoch_;
+    double last_epoch_;
+    double last_lat_, last_lon_, last_alt_;
+};
+
+#endif
@@ -3,6 +3,7 @@
 #include <sensor_msgs/Imu.h>
 #include <sensor_msgs/MagneticField.h>
 #include <sensor_msgs/NavSatFix.h>
+#include <sanchi_amov/Ins.h>
 #include <tf/tf.h>
 #include <eigen3/Eigen/Geometry>
 #include <chrono>
@@ -16,6 +17,11 @@
 #include <boost/assert.hpp>
 #include <boost/asio.hpp>
 #include <boost/asio/serial_port.hpp>
+#include "frame_scan.h"
+#include "frame_unpack.h"
+#include "frame_decode.h"
+#include "ins_sync.h"
+#include "decimator.h"
 
 extern "C"
 {
@@ -45,132 +51,73 @@ static std::string name, frame_id;
 static sensor_msgs::Imu msg;
 static sensor_msgs::MagneticField msg_mag;
 static sensor_msgs::NavSatFix msg_gps;
+static sanchi_amov::Ins msg_ins;
 static int fd_ = -1;
-static ros::Publisher pub, pub_mag, pub_gps;
+static ros::Publisher pub, pub_mag, pub_gps, pub_ins;
+static std::vector<Decimator> decimators;
+static std::vector<ros::Publisher> pub_decimated;
+static sensor_msgs::Imu msg_dec;
 static uint8_t tmp[81];
 
-static float d2f_acc(uint8_t a[2])
+// 发布全速率 data_raw，并送入各抽取滤波器，有输出时发布到 data_raw_decim<N>
+static void publish_imu()
 {
-    int16_t acc = a[0];
-    acc = (acc << 8) | a[1];
-    return ((float)acc) / 16384.0f;
-}
-
-static float d2f_gyro(uint8_t a[2])
-{
-    int16_t acc = a[0];
-    acc = (acc << 8) | a[1];
-    return ((float)acc) / 32.8f;
-}
-
-static float d2f_mag(uint8_t a[2])
-{
-    int16_t acc = a[0];
-    acc = (acc << 8) | a[1];
-    return ((float)acc) / 1.0f;
-}
-
-static float d2f_euler(uint8_t a[2])
-{
-    int16_t acc = a[0];
-    acc = (acc << 8) | a[1];
-    return ((float)acc) / 10.0f;
-}
-
-static double d2f_latlon(uint8_t a[4])
-{
-    int64_t high = a[0];
-    high = (high << 8) | a[1];
-
-    int64_t low = a[2];
-    low = (low << 8) | a[3];
-    return (double)((high << 8) | low);
-}
-
-static double d2f_gpsvel(uint8_t a[2])
-{
-    int16_t acc = a[0];
-    acc = (acc << 8) | a[1];
-    return ((float)acc) / 10.0f;
-}
-
-static float d2ieee754(uint8_t a[4])
-{
-    union fnum
+    pub.publish(msg);
+    if (decimators.empty())
+        return;
+
+    ImuSample sample, out;
+    sample.t = msg.header.stamp.toSec();
+    sample.q = Eigen::Quaterniond(msg.orientation.w, msg.orientation.x, msg.orientation.y, msg.orientation.z);
+    sample.w = Eigen::Vector3d(msg.angular_velocity.x, msg.angular_velocity.y, msg.angular_velocity.z);
+    sample.a = Eigen::Vector3d(msg.linear_acceleration.x, msg.linear_acceleration.y, msg.linear_acceleration.z);
+    for (size_t i = 0; i < decimators.size(); ++i)
     {
-        float f_val;
-        uint8_t d_val[4];
-    } f;
-
-    memcpy(f.d_val, a, 4);
-    return f.f_val;
-}
-// 修改后的欧拉角读取数据
-// 2位数据，低位在前高位在后
-static float d2a2(uint8_t a[2])
-{
-    int16_t acc = a[1];
-    acc = (acc << 8) | a[0];
-    return ((float)acc) / 1.0f;
-    // union fnum
-    // {
-    //     float f_val;
-    //     uint8_t d_val[2];
-    // } f;
-
-    // memcpy(f.d_val, a, 2);
-    // return f.f_val;
-}
-
-// 修改后的欧拉角读取数据
-// 4位数据，低位在前高位在后
-static float d2a4(uint8_t a[4])
-{
-    int64_t high = a[3];
-    high = (high << 8) | a[2];
-
-    int64_t low = a[1];
-    low = (low << 8) | a[0];
-    return (double)((high << 8) | low);
+        if (!decimators[i].push(sample, out))
+            continue;
+        msg_dec.header.stamp = ros::Time(out.t);
+        msg_dec.header.frame_id = msg.header.frame_id;
+        msg_dec.orientation.w = out.q.w();
+        msg_dec.orientation.x = out.q.x();
+        msg_dec.orientation.y = out.q.y();
+        msg_dec.orientation.z = out.q.z();
+        msg_dec.angular_velocity.x = out.w.x();
+        msg_dec.angular_velocity.y = out.w.y();
+        msg_dec.angular_velocity.z = out.w.z();
+        msg_dec.linear_acceleration.x = out.a.x();
+        msg_dec.linear_acceleration.y = out.a.y();
+        msg_dec.linear_acceleration.z = out.a.z();
+        pub_decimated[i].publish(msg_dec);
+    }
 }
 
-static float d2a2ieee(uint8_t a[2])
+static void set_orientation(const Eigen::Quaterniond &q)
 {
-    union fnum
-    {
-        float f_val;
-        uint8_t d_val[2];
-    } f;
-    f.d_val[0] = a[1];
-    f.d_val[1] = a[0];
-    // cout << hex << "f.d_val[0]= " << int(f.d_val[0]) << "  f.d_val[1]= " << int(f.d_val[1]) << endl;
-    // cout << hex << "f.float= " << f.f_val << endl;
-    // memcpy(f.d_val, a, 2);
-    return f.f_val;
+    msg.orientation.w = (double)q.w();
+    msg.orientation.x = (double)q.x();
+    msg.orientation.y = (double)q.y();
+    msg.orientation.z = (double)q.z();
 }
 
-static double d2_32f(uint8_t a[4])
+static void set_motion(const ImuFrame &fr)
 {
-    union fnum
-    {
-        float f_val;
-        uint8_t d_val[4];
-    } f;
-
-    memcpy(f.d_val, a, 4);
-    return f.f_val;
+    msg.angular_velocity.x = fr.w.x();
+    msg.angular_velocity.y = fr.w.y();
+    msg.angular_velocity.z = fr.w.z();
+    msg.linear_acceleration.x = fr.a.x();
+    msg.linear_acceleration.y = fr.a.y();
+    msg.linear_acceleration.z = fr.a.z();
 }
 
-static double d2_64f(uint8_t a[8])
+// 磁场与 msg 同一时间戳
+static void publish_mag(const Eigen::Vector3d &mag)
 {
-    union fnum
-    {
-        double f_val;
-        uint8_t d_val[8];
-    } f;
-
-    memcpy(f.d_val, a, 8);
-    return f.f_val;
+    msg_mag.magnetic_field.x = mag.x();
+    msg_mag.magnetic_field.y = mag.y();
+    msg_mag.magnetic_field.z = mag.z();
+    msg_mag.header.stamp = msg.header.stamp;
+    msg_mag.header.frame_id = msg.header.frame_id;
+    pub_mag.publish(msg_mag);
 }
 
 int uart_set(int fd, int baude, int c_flow, int bits, char parity, int stop)
@@ -334,6 +281,25 @@ int main(int argc, char **argv)
     double delay;
     n.param("delay", delay, 0.0);
 
+    // 200S 组合输出: GPS 历元上的位置 + 插值IMU + 预积分增量，gps_delay 为GPS相对帧的滞后，
+    // 位置不变(静止)时每 ins_max_interval 秒补一个 repeated 历元，须明显长于GPS更新周期
+    bool ins;
+    double gps_delay, ins_max_interval;
+    n.param("ins", ins, false);
+    n.param("gps_delay", gps_delay, 0.0);
+    n.param("ins_max_interval", ins_max_interval, 5.0);
+    InsSync ins_sync(gps_delay, ins_max_interval);
+
+    std::string simd;
+    n.param("simd", simd, string("auto"));
+    const char *kernels = select_frame_kernels(simd.c_str());
+    if (!kernels)
+    {
+        ROS_ERROR("%s: simd %s not supported on this cpu", name.c_str(), simd.c_str());
+        return -1;
+    }
+    ROS_WARN("Frame search uses %s, field unpack uses %s", kernels, select_unpack_kernels(kernels));
+
     boost::asio::io_service io_service;
     serial_port = new boost::asio::serial_port(io_service);
     try
@@ -377,6 +343,25 @@ int main(int argc, char **argv)
     pub = n.advertise<sensor_msgs::Imu>("data_raw", 1);
     pub_mag = n.advertise<sensor_msgs::MagneticField>("mag", 1);
     pub_gps = n.advertise<sensor_msgs::NavSatFix>("gps", 1);
+    if (ins && model == "200S")
+        pub_ins = n.advertise<sanchi_amov::Ins>("ins", 10);
+
+    // 低速率输出，例如 decimation: [10] 在 100Hz 下发布 10Hz 的 data_raw_decim10
+    std::vector<int> decimation;
+    n.getParam("decimation", decimation);
+    for (size_t i = 0; i < decimation.size(); ++i)
+    {
+        if (decimation[i] < 2)
+        {
+            ROS_ERROR("%s: decimation factor must be at least 2", name.c_str());
+            return -1;
+        }
+        std::ostringstream topic;
+        topic << "data_raw_decim" << decimation[i];
+        decimators.push_back(Decimator(decimation[i]));
+        pub_decimated.push_back(n.advertise<sensor_msgs::Imu>(topic.str(), 10));
+        ROS_WARN("Decimating by %d on %s", decimation[i], topic.str().c_str());
+    }
 
     if (model == "100S")
     {
@@ -425,6 +410,14 @@ int main(int argc, char **argv)
         data_length = 40;
     }
 
+    // 100S/100D2 帧头 A5 5A，其余型号 55 AA
+    uint8_t head0 = 0x55, head1 = 0xAA;
+    if (model == "100S" || model == "100D2")
+    {
+        head0 = 0xA5;
+        head1 = 0x5A;
+    }
+
     int kk = 0;
     ROS_WARN("Streaming Data...");
     while (n.ok())
@@ -433,7 +426,8 @@ int main(int argc, char **argv)
         memcpy(data_raw, tmp, sizeof(uint8_t) * data_length);
 
         bool found = false;
-        for (kk = 0; kk < data_length - 1; ++kk)
+        for (kk = find_header(data_raw, 0, data_length, head0, head1); kk < data_length - 1;
+             kk = find_header(data_raw, kk + 1, data_length, head0, head1))
         {
             if (model == "100S" && data_raw[kk] == 0xA5 && data_raw[kk + 1] == 0x5A)
             {
@@ -446,9 +440,7 @@ int main(int argc, char **argv)
                     continue;
                 uint8_t len = data[2];
 
-                uint32_t checksum = 0;
-                for (int i = 0; i < len; ++i)
-                    checksum += (uint32_t)data[i];
+                uint32_t checksum = byte_sum(data, len);
 
                 uint16_t check = checksum % 256 + 1;
                 uint16_t check_true = data[len];
@@ -457,71 +449,26 @@ int main(int argc, char **argv)
                     continue;
                 }
 
+                ImuFrame fr;
                 if (data[3] == 0xA1)
                 {
-                    Eigen::Vector3d ea0(d2f_euler(data + 4) * M_PI / 180.0,
-                                        d2f_euler(data + 6) * M_PI / 180.0,
-                                        d2f_euler(data + 8) * M_PI / 180.0);
-                    Eigen::Matrix3d R;
-                    R = Eigen::AngleAxisd(ea0[0], ::Eigen::Vector3d::UnitZ()) * Eigen::AngleAxisd(ea0[1], ::Eigen::Vector3d::UnitY()) * Eigen::AngleAxisd(ea0[2], ::Eigen::Vector3d::UnitX());
-                    Eigen::Quaterniond q;
-                    q = R;
-                    msg.orientation.w = (double)q.w();
-                    msg.orientation.x = (double)q.x();
-                    msg.orientation.y = (double)q.y();
-                    msg.orientation.z = (double)q.z();
+                    decode_100s_euler(data, sizeof(data_raw) - kk, fr);
+                    set_orientation(fr.q);
                 }
                 else if (data[3] == 0xA2)
                 {
-
+                    decode_100s_imu(data, sizeof(data_raw) - kk, fr);
                     msg.header.stamp = ros::Time::now();
                     msg.header.frame_id = frame_id;
-                    msg.angular_velocity.x = d2f_gyro(data + 10);
-                    msg.angular_velocity.y = d2f_gyro(data + 12);
-                    msg.angular_velocity.z = d2f_gyro(data + 14);
-                    msg.linear_acceleration.x = d2f_acc(data + 4) * 9.81;
-                    msg.linear_acceleration.y = d2f_acc(data + 6) * 9.81;
-                    msg.linear_acceleration.z = d2f_acc(data + 8) * 9.81;
-                    pub.publish(msg);
-
-                    msg_mag.magnetic_field.x = d2f_mag(data + 16);
-                    msg_mag.magnetic_field.y = d2f_mag(data + 18);
-                    msg_mag.magnetic_field.z = d2f_mag(data + 20);
-                    msg_mag.header.stamp = msg.header.stamp;
-                    msg_mag.header.frame_id = msg.header.frame_id;
-                    pub_mag.publish(msg_mag);
+                    set_motion(fr);
+                    publish_imu();
+                    publish_mag(fr.mag);
                 }
-
                 else if (data[3] == 0xA6)
                 {
                     msg_gps.header.stamp = ros::Time::now();
                     msg_gps.header.frame_id = frame_id;
-                    msg_gps.latitude = d2f_latlon(data + 4) * 1e-6;
-                    msg_gps.longitude = d2f_latlon(data + 8) * 1e-6;
-
-                    if (data[18] == 0x22)
-                    {
-                        msg_gps.latitude = msg_gps.latitude;
-                        msg_gps.longitude = msg_gps.longitude;
-                    }
-                    else if (data[18] == 0x12)
-                    {
-                        msg_gps.latitude = -msg_gps.latitude;
-                        msg_gps.longitude = msg_gps.longitude;
-                    }
-                    else if (data[18] == 0x11)
-                    {
-                        msg_gps.latitude = -msg_gps.latitude;
-                        msg_gps.longitude = -msg_gps.longitude;
-                    }
-                    else if (data[18] == 0x21)
-                    {
-                        msg_gps.latitude = msg_gps.latitude;
-                        msg_gps.longitude = -msg_gps.longitude;
-                    }
-
-                    msg_gps.altitude = d2f_latlon(data + 16) / 10.0f;
-
+                    decode_100s_gps(data, msg_gps.latitude, msg_gps.longitude, msg_gps.altitude);
                     pub_gps.publish(msg_gps);
                 }
 
@@ -530,9 +477,7 @@ int main(int argc, char **argv)
             else if (model == "200A" && data_raw[kk] == 0x55 && data_raw[kk + 1] == 0xAA && data_raw[kk + data_length - 1] == 0xBB)
             {
                 unsigned char *data = data_raw + kk;
-                uint32_t checksum = 0;
-                for (int i = 2; i < data_length - 2; ++i)
-                    checksum += (uint32_t)data[i];
+                uint32_t checksum = byte_sum(data + 2, data_length - 4);
 
                 uint16_t check = checksum % 256;
                 uint16_t check_true = data[data_length - 2];
@@ -541,43 +486,22 @@ int main(int argc, char **argv)
                     continue;
                 }
 
-                Eigen::Vector3d ea0(d2ieee754(data + 39) * M_PI / 180.0,
-                                    d2ieee754(data + 43) * M_PI / 180.0,
-                                    d2ieee754(data + 47) * M_PI / 180.0);
-                Eigen::Matrix3d R;
-                R = Eigen::AngleAxisd(ea0[0], ::Eigen::Vector3d::UnitZ()) * Eigen::AngleAxisd(ea0[1], ::Eigen::Vector3d::UnitY()) * Eigen::AngleAxisd(ea0[2], ::Eigen::Vector3d::UnitX());
-                Eigen::Quaterniond q;
-                q = R;
-                msg.orientation.w = (double)q.w();
-                msg.orientation.x = (double)q.x();
-                msg.orientation.y = (double)q.y();
-                msg.orientation.z = (double)q.z();
+                ImuFrame fr;
+                decode_200a(data, sizeof(data_raw) - kk, fr);
+                set_orientation(fr.q);
 
                 msg.header.stamp = ros::Time::now();
                 msg.header.frame_id = frame_id;
-                msg.angular_velocity.x = d2ieee754(data + 15) * M_PI / 180;
-                msg.angular_velocity.y = d2ieee754(data + 19) * M_PI / 180;
-                msg.angular_velocity.z = d2ieee754(data + 23) * M_PI / 180;
-                msg.linear_acceleration.x = d2ieee754(data + 3) * 1e-3 * 9.81;
-                msg.linear_acceleration.y = d2ieee754(data + 7) * 1e-3 * 9.81;
-                msg.linear_acceleration.z = d2ieee754(data + 11) * 1e-3 * 9.81;
-                pub.publish(msg);
-
-                msg_mag.magnetic_field.x = d2ieee754(data + 27);
-                msg_mag.magnetic_field.y = d2ieee754(data + 31);
-                msg_mag.magnetic_field.z = d2ieee754(data + 35);
-                msg_mag.header.stamp = msg.header.stamp;
-                msg_mag.header.frame_id = msg.header.frame_id;
-                pub_mag.publish(msg_mag);
+                set_motion(fr);
+                publish_imu();
+                publish_mag(fr.mag);
 
                 found = true;
             }
             else if (model == "300A" && data_raw[kk] == 0x55 && data_raw[kk + 1] == 0xAA && data_raw[kk + data_length - 1] == 0xBB)
             {
                 unsigned char *data = data_raw + kk;
-                uint32_t checksum = 0;
-                for (int i = 2; i < data_length - 2; ++i)
-                    checksum += (uint32_t)data[i];
+                uint32_t checksum = byte_sum(data + 2, data_length - 4);
 
                 uint16_t check = checksum % 256;
                 uint16_t check_true = data[data_length - 2];
@@ -586,43 +510,22 @@ int main(int argc, char **argv)
                     continue;
                 }
 
-                Eigen::Vector3d ea0(d2ieee754(data + 39) * M_PI / 180.0,
-                                    d2ieee754(data + 43) * M_PI / 180.0,
-                                    d2ieee754(data + 47) * M_PI / 180.0);
-                Eigen::Matrix3d R;
-                R = Eigen::AngleAxisd(ea0[0], ::Eigen::Vector3d::UnitY()) * Eigen::AngleAxisd(-ea0[1], ::Eigen::Vector3d::UnitX()) * Eigen::AngleAxisd(-ea0[2], ::Eigen::Vector3d::UnitZ());
-                Eigen::Quaterniond q;
-                q = R;
-                msg.orientation.w = (double)q.w();
-                msg.orientation.x = (double)q.x();
-                msg.orientation.y = (double)q.y();
-                msg.orientation.z = (double)q.z();
+                ImuFrame fr;
+                decode_300a(data, sizeof(data_raw) - kk, fr);
+                set_orientation(fr.q);
 
                 msg.header.stamp = ros::Time::now();
                 msg.header.frame_id = frame_id;
-                msg.angular_velocity.x = d2ieee754(data + 15) * M_PI / 180;
-                msg.angular_velocity.y = d2ieee754(data + 19) * M_PI / 180;
-                msg.angular_velocity.z = d2ieee754(data + 23) * M_PI / 180;
-                msg.linear_acceleration.x = d2ieee754(data + 3) * 1e-3 * 9.81;
-                msg.linear_acceleration.y = d2ieee754(data + 7) * 1e-3 * 9.81;
-                msg.linear_acceleration.z = d2ieee754(data + 11) * 1e-3 * 9.81;
-                pub.publish(msg);
-
-                msg_mag.magnetic_field.x = d2ieee754(data + 27);
-                msg_mag.magnetic_field.y = d2ieee754(data + 31);
-                msg_mag.magnetic_field.z = d2ieee754(data + 35);
-                msg_mag.header.stamp = msg.header.stamp;
-                msg_mag.header.frame_id = msg.header.frame_id;
-                pub_mag.publish(msg_mag);
+                set_motion(fr);
+                publish_imu();
+                publish_mag(fr.mag);
 
                 found = true;
             }
             else if (model == "200S" && data_raw[kk] == 0x55 && data_raw[kk + 1] == 0xAA && data_raw[kk + data_length - 1] == 0xBB)
             {
                 unsigned char *data = data_raw + kk;
-                uint32_t checksum = 0;
-                for (int i = 2; i < data_length - 2; ++i)
-                    checksum += (uint32_t)data[i];
+                uint32_t checksum = byte_sum(data + 2, data_length - 4);
 
                 uint16_t check = checksum % 256;
                 uint16_t check_true = data[data_length - 2];
@@ -630,83 +533,61 @@ int main(int argc, char **argv)
                 {
                     continue;
                 }
-                // 绕Z,Y,X
-                Eigen::Vector3d ea0(-d2ieee754(data + 25) * M_PI / 180.0,
-                                    -d2ieee754(data + 17) * M_PI / 180.0,
-                                    d2ieee754(data + 21) * M_PI / 180.0);
-                // Eigen::Vector3d ea0(d2ieee754(data + 25) * M_PI / 180.0,
-                //                     d2ieee754(data + 21) * M_PI / 180.0,
-                //                     d2ieee754(data + 17) * M_PI / 180.0);
-                Eigen::Matrix3d R;
-                R = Eigen::AngleAxisd(ea0[0], ::Eigen::Vector3d::UnitZ()) * Eigen::AngleAxisd(ea0[1], ::Eigen::Vector3d::UnitY()) * Eigen::AngleAxisd(ea0[2], ::Eigen::Vector3d::UnitX());
-                Eigen::Quaterniond q;
-                q = R;
-                // cout << "pitch= " << d2ieee754(data + 17) * M_PI / 180.0 << endl;
-                // cout << "roll= " << d2ieee754(data + 21) * M_PI / 180.0 << endl;
-                // cout << hex << int(data[25]) << " " << int(data[26])
-                //      << " " << int(data[27]) << " " << int(data[28]) << endl;
-                // cout << "yaw= " << d2ieee754(data + 25) << endl;
+                ImuFrame fr;
+                decode_200s(data, sizeof(data_raw) - kk, fr);
                 // 先不设置四元数，使用imu_tools检测原始的数据是否正确
-                msg.orientation.w = (double)q.w();
-                msg.orientation.x = (double)q.x();
-                msg.orientation.y = (double)q.y();
-                msg.orientation.z = (double)q.z();
+                set_orientation(fr.q);
 
                 msg.header.stamp = ros::Time::now();
                 msg.header.frame_id = frame_id;
+                set_motion(fr);
+                publish_imu();
+                publish_mag(fr.mag);
 
-                msg.angular_velocity.x = d2a2(data + 11) * 0.02 * M_PI / 180;
-                msg.angular_velocity.y = -d2a2(data + 9) * 0.02 * M_PI / 180;
-                msg.angular_velocity.z = d2a2(data + 13) * 0.02 * M_PI / 180;
-                msg.linear_acceleration.x = d2a2(data + 5) * 0.5 * 1e-3 * 9.81;
-                msg.linear_acceleration.y = -d2a2(data + 3) * 0.5 * 1e-3 * 9.81;
-                msg.linear_acceleration.z = d2a2(data + 7) * 0.5 * 1e-3 * 9.81;
-
-                // msg.angular_velocity.x = d2a2(data + 9) * 0.02 * M_PI / 180;
-                // msg.angular_velocity.y = d2a2(data + 11) * 0.02 * M_PI / 180;
-                // msg.angular_velocity.z = d2a2(data + 13) * 0.02 * M_PI / 180;
-                // msg.linear_acceleration.x = d2a2(data + 3) * 0.5 * 1e-3 * 9.81;
-                // msg.linear_acceleration.y = d2a2(data + 5) * 0.5 * 1e-3 * 9.81;
-                // msg.linear_acceleration.z = d2a2(data + 7) * 0.5 * 1e-3 * 9.81;
-
-                double tempZ = d2a2ieee(data + 7) * 0.5 * 1e-3 * 9.81;
-                // 温度
-                double temperature = d2a2(data + 15) * 0.01;
-
-                pub.publish(msg);
-
-                msg_mag.magnetic_field.x = d2a2(data + 72);
-                msg_mag.magnetic_field.y = -d2a2(data + 70);
-                msg_mag.magnetic_field.z = d2a2(data + 74);
-
-                // msg_mag.magnetic_field.x = d2a2(data + 70);
-                // msg_mag.magnetic_field.y = d2a2(data + 72);
-                // msg_mag.magnetic_field.z = d2a2(data + 74);
-                // 应该是正确的数值
-                // double magX = d2a2(data + 70);
-                // double magY = d2a2(data + 72);
-                // double magZ = d2a2(data + 74);
-
-                msg_mag.header.stamp = msg.header.stamp;
-                msg_mag.header.frame_id = msg.header.frame_id;
-                pub_mag.publish(msg_mag);
-
-                msg_gps.header.stamp = ros::Time::now();
+                // IMU、磁场、GPS 出自同一帧，用同一个时间戳
+                msg_gps.header.stamp = msg.header.stamp;
                 msg_gps.header.frame_id = frame_id;
-                // 这个应该有问题，但是没有上机测试
-                msg_gps.latitude = d2_64f(data + 43);
-                msg_gps.longitude = d2_64f(data + 35);
-                // cout << hex << int(data[51]) << " " << int(data[52]) << " "
-                //      << int(data[53]) << " " << int(data[54]) << " " << endl;
-                // cout << d2a4(data + 51) << "\t" << d2_32f(data + 51) << endl;
-                // msg_gps.altitude = d2a4(data + 51);
-                msg_gps.altitude = d2_32f(data + 51);
-                // ROS_INFO("latitude = %f",msg_gps.latitude);
-                // ROS_INFO("longitude = %f",msg_gps.longitude);
-                // ROS_INFO("altitude = %f", msg_gps.altitude);
+                decode_200s_gps(data, msg_gps.latitude, msg_gps.longitude, msg_gps.altitude);
 
                 pub_gps.publish(msg_gps);
 
+                if (ins)
+                {
+                    ImuSample sample;
+                    sample.t = msg.header.stamp.toSec();
+                    sample.q = fr.q;
+                    sample.w = Eigen::Vector3d(msg.angular_velocity.x, msg.angular_velocity.y, msg.angular_velocity.z);
+                    sample.a = Eigen::Vector3d(msg.linear_acceleration.x, msg.linear_acceleration.y, msg.linear_acceleration.z);
+                    InsState state;
+                    if (ins_sync.push(sample, msg_gps.latitude, msg_gps.longitude, msg_gps.altitude, state))
+                    {
+                        msg_ins.header.stamp = ros::Time(state.t);
+                        msg_ins.header.frame_id = frame_id;
+                        msg_ins.repeated = state.repeated;
+                        msg_ins.latitude = state.latitude;
+                        msg_ins.longitude = state.longitude;
+                        msg_ins.altitude = state.altitude;
+                        msg_ins.orientation.w = state.imu.q.w();
+                        msg_ins.orientation.x = state.imu.q.x();
+                        msg_ins.orientation.y = state.imu.q.y();
+                        msg_ins.orientation.z = state.imu.q.z();
+                        msg_ins.angular_velocity.x = state.imu.w.x();
+                        msg_ins.angular_velocity.y = state.imu.w.y();
+                        msg_ins.angular_velocity.z = state.imu.w.z();
+                        msg_ins.linear_acceleration.x = state.imu.a.x();
+                        msg_ins.linear_acceleration.y = state.imu.a.y();
+                        msg_ins.linear_acceleration.z = state.imu.a.z();
+                        msg_ins.delta_velocity.x = state.delta_velocity.x();
+                        msg_ins.delta_velocity.y = state.delta_velocity.y();
+                        msg_ins.delta_velocity.z = state.delta_velocity.z();
+                        msg_ins.delta_angle.x = state.delta_angle.x();
+                        msg_ins.delta_angle.y = state.delta_angle.y();
+                        msg_ins.delta_angle.z = state.delta_angle.z();
+                        msg_ins.delta_time = state.delta_time;
+                        pub_ins.publish(msg_ins);
+                    }
+                }
+
                 found = true;
             }
             if (model == "100D2" && data_raw[kk] == 0xA5 && data_raw[kk + 1] == 0x5A)
@@ -715,11 +596,7 @@ int main(int argc, char **argv)
 
                 uint8_t data_length = data[2];
 
-                uint32_t checksum = 0;
-                for (int i = 0; i < data_length - 1; ++i)
-                {
-                    checksum += (uint32_t)data[i + 2];
-                }
+                uint32_t checksum = byte_sum(data + 2, data_length - 1);
 
                 uint16_t check = checksum % 256;
                 uint16_t check_true = data[data_length + 1];
@@ -730,34 +607,15 @@ int main(int argc, char **argv)
                     continue;
                 }
 
-                Eigen::Vector3d ea0(-d2f_euler(data + 3) * M_PI / 180.0,
-                                    d2f_euler(data + 7) * M_PI / 180.0,
-                                    d2f_euler(data + 5) * M_PI / 180.0);
-                Eigen::Matrix3d R;
-                R = Eigen::AngleAxisd(ea0[0], ::Eigen::Vector3d::UnitZ()) * Eigen::AngleAxisd(ea0[1], ::Eigen::Vector3d::UnitY()) * Eigen::AngleAxisd(ea0[2], ::Eigen::Vector3d::UnitX());
-                Eigen::Quaterniond q;
-                q = R;
-                msg.orientation.w = (double)q.w();
-                msg.orientation.x = (double)q.x();
-                msg.orientation.y = (double)q.y();
-                msg.orientation.z = (double)q.z();
+                ImuFrame fr;
+                decode_100d2(data, sizeof(data_raw) - kk, fr);
+                set_orientation(fr.q);
 
                 msg.header.stamp = ros::Time::now();
                 msg.header.frame_id = frame_id;
-                msg.angular_velocity.x = d2f_gyro(data + 15);
-                msg.angular_velocity.y = d2f_gyro(data + 17);
-                msg.angular_velocity.z = d2f_gyro(data + 19);
-                msg.linear_acceleration.x = d2f_acc(data + 9) * 9.81;
-                msg.linear_acceleration.y = d2f_acc(data + 11) * 9.81;
-                msg.linear_acceleration.z = d2f_acc(data + 13) * 9.81;
-                pub.publish(msg);
-
-                msg_mag.magnetic_field.x = d2f_mag(data + 21);
-                msg_mag.magnetic_field.y = d2f_mag(data + 23);
-                msg_mag.magnetic_field.z = d2f_mag(data + 25);
-                msg_mag.header.stamp = msg.header.stamp;
-                msg_mag.header.frame_id = msg.header.frame_id;
-                pub_mag.publish(msg_mag);
+                set_motion(fr);
+                publish_imu();
+                publish_mag(fr.mag);
 
                 found = true;
             }
@@ -0,0 +1,505 @@
+// 虚拟三驰IMU: 在伪终端上模拟 100S/100D2/200A/200S/300A，
+// 响应 stop/mode/0xA8 设速命令，按给定频率发帧并注入故障，
+// 同时订阅驱动发布的 data_raw，与发送内容比对统计丢帧、错帧和延时
+#include <cmath>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <ros/ros.h>
+#include <sensor_msgs/Imu.h>
+#include "frame_scan.h"
+#include "frame_unpack.h"
+
+extern "C"
+{
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <errno.h>
+#include <termios.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+using namespace std;
+
+// 消息值 = 原始值 * k
+struct Axis
+{
+    int offset;
+    FieldType type;
+    double k;
+};
+
+struct Model
+{
+    const char *name;
+    int length; // 每个采样发送的字节数
+    Axis acc[3];
+    Axis gyro[3];
+};
+
+static const double G = 9.81;
+static const double D2R = M_PI / 180.0;
+
+// 100S 的偏移相对 A2 包头(A1 包在前，占22字节)
+static const Model models[] = {
+    {"100S", 46,
+     {{4, FIELD_I16_BE, G / 16384.0}, {6, FIELD_I16_BE, G / 16384.0}, {8, FIELD_I16_BE, G / 16384.0}},
+     {{10, FIELD_I16_BE, 1 / 32.8}, {12, FIELD_I16_BE, 1 / 32.8}, {14, FIELD_I16_BE, 1 / 32.8}}},
+    {"100D2", 40,
+     {{9, FIELD_I16_BE, G / 16384.0}, {11, FIELD_I16_BE, G / 16384.0}, {13, FIELD_I16_BE, G / 16384.0}},
+     {{15, FIELD_I16_BE, 1 / 32.8}, {17, FIELD_I16_BE, 1 / 32.8}, {19, FIELD_I16_BE, 1 / 32.8}}},
+    {"200A", 61,
+     {{3, FIELD_F32_LE, 1e-3 * G}, {7, FIELD_F32_LE, 1e-3 * G}, {11, FIELD_F32_LE, 1e-3 * G}},
+     {{15, FIELD_F32_LE, D2R}, {19, FIELD_F32_LE, D2R}, {23, FIELD_F32_LE, D2R}}},
+    {"300A", 61,
+     {{3, FIELD_F32_LE, 1e-3 * G}, {7, FIELD_F32_LE, 1e-3 * G}, {11, FIELD_F32_LE, 1e-3 * G}},
+     {{15, FIELD_F32_LE, D2R}, {19, FIELD_F32_LE, D2R}, {23, FIELD_F32_LE, D2R}}},
+    // 200S 原始顺序为 Y X Z，Y 取反
+    {"200S", 92,
+     {{5, FIELD_I16_LE, 0.5e-3 * G}, {3, FIELD_I16_LE, -0.5e-3 * G}, {7, FIELD_I16_LE, 0.5e-3 * G}},
+     {{11, FIELD_I16_LE, 0.02 * D2R}, {9, FIELD_I16_LE, -0.02 * D2R}, {13, FIELD_I16_LE, 0.02 * D2R}}},
+};
+
+// 已发送、等待驱动发布的采样，以角速度X的原始值为键
+struct Sent
+{
+    uint32_t seq;
+    double time;
+    double raw[6];
+    bool faulted;
+};
+
+static const Model *model = 0;
+static std::mutex lock_;
+static std::map<int, Sent> inflight_;
+static double timeout = 1.0;
+static double tolerance = 1e-5;
+
+static unsigned long sent = 0, faulted = 0, received = 0, lost = 0, lost_clean = 0,
+                     corrupt = 0, unmatched = 0, overrun = 0;
+static std::vector<double> latency_;
+static double latency_max = 0;
+
+static double now_sec()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static bool is_float_model()
+{
+    return model->gyro[0].type == FIELD_F32_LE;
+}
+
+// 序号放在角速度X里，整型型号取 0..16383，浮点型号取 0..2^20-1
+static int seq_key(uint32_t seq)
+{
+    return is_float_model() ? (int)(seq & 0xFFFFF) : (int)(seq & 0x3FFF);
+}
+
+static void sample_raw(uint32_t seq, double raw[6])
+{
+    static const int primes[6] = {0, 37, 101, 211, 307, 401};
+    for (int i = 0; i < 6; ++i)
+        raw[i] = (double)((int)((seq * primes[i] + 13 * i) % 2001) - 1000);
+    raw[3] = seq_key(seq);
+}
+
+static void put_field(uint8_t *a, FieldType type, double v)
+{
+    if (type == FIELD_F32_LE)
+    {
+        float f = (float)v;
+        memcpy(a, &f, 4);
+        return;
+    }
+    int16_t i = (int16_t)v;
+    if (type == FIELD_I16_BE)
+    {
+        a[0] = (uint8_t)(i >> 8);
+        a[1] = (uint8_t)i;
+    }
+    else
+    {
+        a[0] = (uint8_t)i;
+        a[1] = (uint8_t)(i >> 8);
+    }
+}
+
+static void put_axes(uint8_t *a, const double raw[6])
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        put_field(a + model->acc[i].offset, model->acc[i].type, raw[i]);
+        put_field(a + model->gyro[i].offset, model->gyro[i].type, raw[3 + i]);
+    }
+}
+
+// 生成一个采样的完整帧，返回字节数
+static int build_frame(uint32_t seq, const double raw[6], double gps_epoch, uint8_t *out)
+{
+    int n = model->length;
+    memset(out, 0, n);
+    if (strcmp(model->name, "100S") == 0)
+    {
+        // A1 欧拉角包(全0)，A2 加速度/角速度/磁场包，校验为累加和加1
+        uint8_t *a1 = out, *a2 = out + 22;
+        a1[0] = 0xA5, a1[1] = 0x5A, a1[2] = 0x14, a1[3] = 0xA1;
+        a1[0x14] = (uint8_t)(byte_sum(a1, 0x14) + 1);
+        a1[0x15] = 0xAA;
+        a2[0] = 0xA5, a2[1] = 0x5A, a2[2] = 0x16, a2[3] = 0xA2;
+        put_axes(a2, raw);
+        a2[0x16] = (uint8_t)(byte_sum(a2, 0x16) + 1);
+        a2[0x17] = 0xAA;
+    }
+    else if (strcmp(model->name, "100D2") == 0)
+    {
+        out[0] = 0xA5, out[1] = 0x5A, out[2] = n - 2;
+        put_axes(out, raw);
+        out[n - 1] = (uint8_t)byte_sum(out + 2, n - 3);
+    }
+    else
+    {
+        out[0] = 0x55, out[1] = 0xAA;
+        put_axes(out, raw);
+        if (strcmp(model->name, "200S") == 0)
+        {
+            // GPS 每个历元移动一点，经度35、纬度43(double)，高度51(float)
+            double lon = 114.0 + gps_epoch * 1e-6, lat = 22.5 + gps_epoch * 1e-6;
+            float alt = 50.0f;
+            memcpy(out + 35, &lon, 8);
+            memcpy(out + 43, &lat, 8);
+            memcpy(out + 51, &alt, 4);
+        }
+        out[n - 2] = (uint8_t)byte_sum(out + 2, n - 4);
+        out[n - 1] = 0xBB;
+    }
+    return n;
+}
+
+static void imu_callback(const sensor_msgs::ImuConstPtr &msg)
+{
+    double t = now_sec();
+    double got[6] = {msg->linear_acceleration.x, msg->linear_acceleration.y, msg->linear_acceleration.z,
+                     msg->angular_velocity.x, msg->angular_velocity.y, msg->angular_velocity.z};
+    int key = (int)lround(got[3] / model->gyro[0].k);
+
+    std::lock_guard<std::mutex> guard(lock_);
+    std::map<int, Sent>::iterator it = inflight_.find(key);
+    if (it == inflight_.end())
+    {
+        ++unmatched;
+        return;
+    }
+    const Sent &s = it->second;
+    bool match = true;
+    for (int i = 0; i < 6; ++i)
+    {
+        double k = i < 3 ? model->acc[i].k : model->gyro[i - 3].k;
+        double expect = s.raw[i] * k;
+        if (fabs(got[i] - expect) > tolerance * max(1.0, fabs(expect)))
+            match = false;
+    }
+    if (match)
+    {
+        ++received;
+        latency_.push_back(t - s.time);
+        latency_max = max(latency_max, t - s.time);
+    }
+    else
+    {
+        ++corrupt;
+    }
+    inflight_.erase(it);
+}
+
+// 超时未发布的采样记为丢失
+static void expire(double t)
+{
+    for (std::map<int, Sent>::iterator it = inflight_.begin(); it != inflight_.end();)
+    {
+        if (t - it->second.time > timeout)
+        {
+            ++lost;
+            if (!it->second.faulted)
+                ++lost_clean;
+            inflight_.erase(it++);
+        }
+        else
+            ++it;
+    }
+}
+
+static void report(const char *tag)
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    double mean = 0, p99 = 0;
+    if (!latency_.empty())
+    {
+        for (size_t i = 0; i < latency_.size(); ++i)
+            mean += latency_[i];
+        mean /= latency_.size();
+        std::sort(latency_.begin(), latency_.end());
+        p99 = latency_[latency_.size() * 99 / 100];
+    }
+    ROS_INFO("%s sent %lu (faulted %lu) received %lu lost %lu (clean %lu) corrupt %lu unmatched %lu "
+             "overrun %lu loss %.3f%% latency mean %.3f p99 %.3f max %.3f ms",
+             tag, sent, faulted, received, lost, lost_clean, corrupt, unmatched, overrun,
+             sent ? 100.0 * lost / sent : 0.0, mean * 1e3, p99 * 1e3, latency_max * 1e3);
+    latency_.clear();
+}
+
+static int open_pty(std::string &slave, int &slave_fd, const std::string &link)
+{
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd < 0 || grantpt(fd) < 0 || unlockpt(fd) < 0)
+    {
+        ROS_ERROR("posix_openpt failed: %s", strerror(errno));
+        return -1;
+    }
+    slave = ptsname(fd);
+
+    // 保持从端打开，驱动未连接时主端不会读到EIO
+    slave_fd = open(slave.c_str(), O_RDWR | O_NOCTTY);
+    struct termios options;
+    tcgetattr(slave_fd, &options);
+    cfmakeraw(&options);
+    tcsetattr(slave_fd, TCSANOW, &options);
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    if (!link.empty())
+    {
+        unlink(link.c_str());
+        if (symlink(slave.c_str(), link.c_str()) < 0)
+            ROS_WARN("symlink %s failed: %s", link.c_str(), strerror(errno));
+    }
+    ROS_WARN("Emulating %s on %s %s", model->name, slave.c_str(), link.c_str());
+    return fd;
+}
+
+int main(int argc, char **argv)
+{
+    ros::init(argc, argv, "sanchi_emulator");
+    ros::NodeHandle n("~");
+
+    std::string model_name;
+    n.param("model", model_name, string("200S"));
+    for (size_t i = 0; i < sizeof(models) / sizeof(models[0]); ++i)
+    {
+        if (model_name == models[i].name)
+            model = &models[i];
+    }
+    if (!model)
+    {
+        ROS_ERROR("unknown model %s", model_name.c_str());
+        return -1;
+    }
+
+    int baud;
+    double rate, gps_rate, report_period;
+    double flip_rate, drop_rate, burst_rate, disconnect_period, disconnect_duration;
+    int burst_length, seed;
+    bool hangup, streaming;
+    std::string link, topic;
+    n.param("baud", baud, 921600);
+    n.param("rate", rate, 100.0);
+    n.param("gps_rate", gps_rate, 5.0);
+    n.param("link", link, string("/tmp/ttySanchi"));
+    n.param("topic", topic, string("/imu/data_raw"));
+    n.param("report_period", report_period, 10.0);
+    n.param("timeout", timeout, 1.0);
+    n.param("tolerance", tolerance, 1e-5);
+    n.param("autostart", streaming, true);
+    // 故障注入: 每字节翻转/丢弃概率，每秒突发次数及长度，周期性断线
+    n.param("flip_rate", flip_rate, 0.0);
+    n.param("drop_rate", drop_rate, 0.0);
+    n.param("burst_rate", burst_rate, 0.0);
+    n.param("burst_length", burst_length, 32);
+    n.param("disconnect_period", disconnect_period, 0.0);
+    n.param("disconnect_duration", disconnect_duration, 1.0);
+    n.param("hangup", hangup, false);
+    n.param("seed", seed, 1);
+
+    // 10位/字节的波特率上限
+    double max_rate = baud / 10.0 / model->length;
+    if (rate > max_rate)
+    {
+        ROS_WARN("rate %.1f exceeds baud limit, using %.1f", rate, max_rate);
+        rate = max_rate;
+    }
+
+    std::string slave;
+    int slave_fd = -1;
+    int fd = open_pty(slave, slave_fd, link);
+    if (fd < 0)
+        return -1;
+
+    ros::Subscriber sub = n.subscribe(topic, 1000, imu_callback);
+    ros::AsyncSpinner spinner(1);
+    spinner.start();
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> uni(0.0, 1.0);
+    std::deque<uint8_t> cmd;
+    uint8_t frame[128];
+    std::vector<uint8_t> wire;
+
+    uint32_t seq = 0;
+    double start = now_sec(), next = start, last_report = start;
+    double down_until = 0, next_disconnect = start + disconnect_period;
+
+    while (ros::ok())
+    {
+        double t = now_sec();
+
+        // 命令: A5 5A len ... checksum AA，checksum 为 data[2..len) 之和
+        uint8_t rx[64];
+        ssize_t r;
+        while ((r = read(fd, rx, sizeof(rx))) > 0)
+            cmd.insert(cmd.end(), rx, rx + r);
+        while (cmd.size() >= 2 && !(cmd[0] == 0xA5 && cmd[1] == 0x5A))
+            cmd.pop_front();
+        if (cmd.size() >= 3 && cmd.size() >= (size_t)cmd[2] + 2)
+        {
+            int len = cmd[2];
+            uint32_t sum = 0;
+            for (int i = 2; i < len; ++i)
+                sum += cmd[i];
+            if (len >= 4 && (uint8_t)sum == cmd[len] && cmd[len + 1] == 0xAA)
+            {
+                if (cmd[3] == 0x02)
+                {
+                    streaming = false;
+                    ROS_WARN("stop");
+                }
+                else if (cmd[3] == 0x01)
+                {
+                    streaming = true;
+                    ROS_WARN("mode");
+                }
+                else if (cmd[3] == 0xA8 && len == 5)
+                {
+                    rate = min((double)max(1, (int)cmd[4]), max_rate);
+                    next = t;
+                    ROS_WARN("speed %.0f Hz", rate);
+                }
+                cmd.erase(cmd.begin(), cmd.begin() + len + 2);
+            }
+            else
+            {
+                cmd.pop_front();
+            }
+        }
+
+        if (disconnect_period > 0 && t >= next_disconnect)
+        {
+            down_until = t + disconnect_duration;
+            next_disconnect = t + disconnect_period;
+            ROS_WARN("disconnect for %.1f s", disconnect_duration);
+            if (hangup)
+            {
+                ::close(fd);
+                ::close(slave_fd);
+                fd = open_pty(slave, slave_fd, link);
+                if (fd < 0)
+                    return -1;
+            }
+        }
+
+        if (t >= next)
+        {
+            next += 1.0 / rate;
+            if (next < t)
+                next = t + 1.0 / rate;
+
+            if (streaming && t >= down_until)
+            {
+                Sent s;
+                s.seq = seq;
+                s.time = t;
+                s.faulted = false;
+                sample_raw(seq, s.raw);
+                int len = build_frame(seq, s.raw, floor((t - start) * gps_rate), frame);
+
+                wire.clear();
+                for (int i = 0; i < len; ++i)
+                {
+                    if (drop_rate > 0 && uni(rng) < drop_rate)
+                    {
+                        s.faulted = true;
+                        continue;
+                    }
+                    uint8_t b = frame[i];
+                    if (flip_rate > 0 && uni(rng) < flip_rate)
+                    {
+                        b ^= (uint8_t)(1 << (rng() % 8));
+                        s.faulted = true;
+                    }
+                    wire.push_back(b);
+                }
+                if (burst_rate > 0 && uni(rng) < burst_rate / rate)
+                {
+                    size_t at = rng() % (wire.size() + 1);
+                    std::vector<uint8_t> burst(burst_length);
+                    for (int i = 0; i < burst_length; ++i)
+                        burst[i] = (uint8_t)rng();
+                    wire.insert(wire.begin() + at, burst.begin(), burst.end());
+                    s.faulted = true;
+                }
+
+                ssize_t w = write(fd, wire.data(), wire.size());
+                {
+                    std::lock_guard<std::mutex> guard(lock_);
+                    if (w < (ssize_t)wire.size())
+                    {
+                        ++overrun;
+                        s.faulted = true;
+                    }
+                    inflight_[seq_key(seq)] = s;
+                    ++sent;
+                    if (s.faulted)
+                        ++faulted;
+                }
+                ++seq;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            expire(t);
+        }
+        if (report_period > 0 && t - last_report >= report_period)
+        {
+            report("soak:");
+            last_report = t;
+        }
+
+        // 等到下一帧或命令到达
+        struct pollfd pfd = {fd, POLLIN, 0};
+        double wait = max(0.0, min(next - now_sec(), 0.01));
+        struct timespec ts = {0, (long)(wait * 1e9)};
+        ppoll(&pfd, 1, &ts, 0);
+    }
+
+    // 等驱动发完在途的采样
+    usleep((useconds_t)(timeout * 1e6));
+    spinner.stop();
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        expire(now_sec() + timeout + 1);
+    }
+    report("total:");
+    if (!link.empty())
+        unlink(link.c_str());
+    ::close(fd);
+    ::close(slave_fd);
+    return 0;
+}
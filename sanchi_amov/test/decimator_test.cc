@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include <math.h>
+#include <algorithm>
+#include "../src/decimator.h"
+
+// 100Hz 采样，第 i 个采样的时刻
+static double sample_time(int i)
+{
+    return 100.0 + i * 0.01;
+}
+
+static ImuSample still_sample(int i)
+{
+    ImuSample s;
+    s.t = sample_time(i);
+    s.q = Eigen::Quaterniond::Identity();
+    s.w.setZero();
+    s.a.setZero();
+    return s;
+}
+
+// 第一个输出在窗口填满(16N+1 个采样)时，之后每 N 个一个，时间戳为窗口中心采样的时刻
+TEST(Decimator, Cadence)
+{
+    const int factors[] = {2, 5, 10};
+    for (int n = 0; n < 3; ++n)
+    {
+        int factor = factors[n];
+        Decimator dec(factor);
+        int expected = 16 * factor;
+        for (int i = 0; i < 40 * factor; ++i)
+        {
+            ImuSample out;
+            bool ready = dec.push(still_sample(i), out);
+            ASSERT_EQ(i == expected, ready) << "factor " << factor << " sample " << i;
+            if (ready)
+            {
+                EXPECT_EQ(sample_time(i - 8 * factor), out.t);
+                expected += factor;
+            }
+        }
+    }
+}
+
+TEST(Decimator, DcGain)
+{
+    Decimator dec(10);
+    int count = 0;
+    for (int i = 0; i < 1000; ++i)
+    {
+        ImuSample s = still_sample(i), out;
+        s.w = Eigen::Vector3d(1.0, -2.0, 3.0);
+        s.a = Eigen::Vector3d(0.0, 0.0, 9.81);
+        if (!dec.push(s, out))
+            continue;
+        ++count;
+        EXPECT_NEAR(0.0, (out.w - s.w).norm(), 1e-12);
+        EXPECT_NEAR(0.0, (out.a - s.a).norm(), 1e-12);
+    }
+    EXPECT_GT(count, 0);
+}
+
+// 频率 f(周期/采样)的正弦、余弦分别送入 w.x、w.y，每个输出的 |(w.x, w.y)| 即该频率的增益
+static double gain(int factor, double f)
+{
+    Decimator dec(factor);
+    double worst = -1, best = 1e9;
+    for (int i = 0; i < 24 * factor + 20 * factor; ++i)
+    {
+        ImuSample s = still_sample(i), out;
+        s.w = Eigen::Vector3d(sin(2 * M_PI * f * i), cos(2 * M_PI * f * i), 0);
+        if (!dec.push(s, out))
+            continue;
+        double g = out.w.head<2>().norm();
+        worst = std::max(worst, g);
+        best = std::min(best, g);
+    }
+    // 线性相位FIR对复指数的增益与时刻无关
+    EXPECT_NEAR(worst, best, 1e-9);
+    return worst;
+}
+
+// 指标: f >= 0.5/N 衰减 >= 70dB，f <= 0.2/N 起伏 < 0.1dB
+TEST(Decimator, Response)
+{
+    const int factors[] = {2, 5, 10};
+    for (int n = 0; n < 3; ++n)
+    {
+        int factor = factors[n];
+        for (int k = 0; k <= 50; ++k)
+        {
+            double f = 0.5 / factor + (0.5 - 0.5 / factor) * k / 50;
+            EXPECT_LT(20 * log10(gain(factor, f)), -70.0) << "factor " << factor << " f " << f;
+        }
+        for (int k = 0; k <= 10; ++k)
+        {
+            double f = 0.2 / factor * k / 10;
+            EXPECT_LT(fabs(20 * log10(gain(factor, f))), 0.1) << "factor " << factor << " f " << f;
+        }
+    }
+}
+
+// 斜坡输入经对称FIR后应正好落在输出时间戳上
+TEST(Decimator, RampAlignment)
+{
+    const int factors[] = {5, 10};
+    for (int n = 0; n < 2; ++n)
+    {
+        Decimator dec(factors[n]);
+        for (int i = 0; i < 400; ++i)
+        {
+            ImuSample s = still_sample(i), out;
+            s.w = Eigen::Vector3d(s.t, -s.t, 0);
+            s.a = Eigen::Vector3d(2 * s.t + 1, 0, 0);
+            if (!dec.push(s, out))
+                continue;
+            EXPECT_NEAR(out.t, out.w.x(), 1e-9);
+            EXPECT_NEAR(-out.t, out.w.y(), 1e-9);
+            EXPECT_NEAR(2 * out.t + 1, out.a.x(), 1e-9);
+        }
+    }
+}
+
+// 匀速转动时平均姿态应是输出时刻的姿态，奇偶 N 都一样
+TEST(Decimator, OrientationAlignment)
+{
+    const int factors[] = {2, 5, 10};
+    for (int n = 0; n < 3; ++n)
+    {
+        Decimator dec(factors[n]);
+        int count = 0;
+        for (int i = 0; i < 600; ++i)
+        {
+            ImuSample s = still_sample(i), out;
+            s.q = Eigen::Quaterniond(Eigen::AngleAxisd(1.0 * (s.t - 100.0), Eigen::Vector3d::UnitZ()));
+            if (!dec.push(s, out))
+                continue;
+            ++count;
+            Eigen::Quaterniond expected(Eigen::AngleAxisd(1.0 * (out.t - 100.0), Eigen::Vector3d::UnitZ()));
+            EXPECT_NEAR(0.0, out.q.angularDistance(expected), 1e-9) << "factor " << factors[n];
+        }
+        EXPECT_GT(count, 0);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,278 @@
+#include <gtest/gtest.h>
+
+#include <math.h>
+#include <string.h>
+#include "../src/frame_decode.h"
+#include "../src/frame_unpack.h"
+
+// 固定帧经 unpack_fields 和各型号的轴映射后的输出。期望值按协议直接写出
+// (原始值/比例，符号与轴序手工给定)，标量和SSE2、直接读取和拷贝到缓冲区两条路径都要一致
+
+static void put_i16_be(uint8_t *a, int16_t v)
+{
+    a[0] = (uint16_t)v >> 8;
+    a[1] = (uint16_t)v & 0xFF;
+}
+
+static void put_i16_le(uint8_t *a, int16_t v)
+{
+    a[0] = (uint16_t)v & 0xFF;
+    a[1] = (uint16_t)v >> 8;
+}
+
+static void put_i32_be(uint8_t *a, int32_t v)
+{
+    for (int i = 0; i < 4; ++i)
+        a[i] = (uint32_t)v >> (24 - 8 * i);
+}
+
+static void put_f32(uint8_t *a, float v)
+{
+    memcpy(a, &v, 4);
+}
+
+static void put_f64(uint8_t *a, double v)
+{
+    memcpy(a, &v, 8);
+}
+
+static Eigen::Quaterniond rotation(double a0, const Eigen::Vector3d &axis0,
+                                   double a1, const Eigen::Vector3d &axis1,
+                                   double a2, const Eigen::Vector3d &axis2)
+{
+    Eigen::Matrix3d R;
+    R = Eigen::AngleAxisd(a0, axis0) * Eigen::AngleAxisd(a1, axis1) * Eigen::AngleAxisd(a2, axis2);
+    return Eigen::Quaterniond(R);
+}
+
+static void expect_quaternion(const Eigen::Quaterniond &expected, const Eigen::Quaterniond &q)
+{
+    EXPECT_DOUBLE_EQ(expected.w(), q.w());
+    EXPECT_DOUBLE_EQ(expected.x(), q.x());
+    EXPECT_DOUBLE_EQ(expected.y(), q.y());
+    EXPECT_DOUBLE_EQ(expected.z(), q.z());
+}
+
+static const double deg = M_PI / 180.0;
+static const Eigen::Vector3d X = Eigen::Vector3d::UnitX();
+static const Eigen::Vector3d Y = Eigen::Vector3d::UnitY();
+static const Eigen::Vector3d Z = Eigen::Vector3d::UnitZ();
+
+// 每个用例在 标量/SSE2 × 帧后有余量/恰好到帧尾 四种组合下运行
+class FrameDecode : public testing::TestWithParam<const char *>
+{
+protected:
+    virtual void SetUp()
+    {
+        ASSERT_STREQ(GetParam(), select_unpack_kernels(GetParam()));
+        memset(frame, 0, sizeof(frame));
+    }
+
+    virtual void TearDown()
+    {
+        select_unpack_kernels("auto");
+    }
+
+    // 100S 的 A1/A2 只填一部分
+    static void clear(ImuFrame &f)
+    {
+        f.q = Eigen::Quaterniond::Identity();
+        f.w.setZero();
+        f.a.setZero();
+        f.mag.setZero();
+    }
+
+    template <typename Decode>
+    void decode(Decode fn, int frame_length, ImuFrame &out)
+    {
+        // 帧后有余量时直接整块读取；恰好到帧尾时SSE2路径要先拷到缓冲区，两者须相同
+        ImuFrame tight;
+        clear(out);
+        clear(tight);
+        fn(frame, sizeof(frame), out);
+        fn(frame, frame_length, tight);
+        EXPECT_EQ(out.q.coeffs(), tight.q.coeffs());
+        EXPECT_EQ(out.w, tight.w);
+        EXPECT_EQ(out.a, tight.a);
+        EXPECT_EQ(out.mag, tight.mag);
+    }
+
+    uint8_t frame[200];
+};
+
+TEST_P(FrameDecode, Model100SEuler)
+{
+    put_i16_be(frame + 4, 900);
+    put_i16_be(frame + 6, 0);
+    put_i16_be(frame + 8, 0);
+    ImuFrame out;
+    decode(decode_100s_euler, 0x16, out);
+    // 航向 90 度，绕Z
+    EXPECT_NEAR(sqrt(0.5), out.q.w(), 1e-12);
+    EXPECT_NEAR(0.0, out.q.x(), 1e-12);
+    EXPECT_NEAR(0.0, out.q.y(), 1e-12);
+    EXPECT_NEAR(sqrt(0.5), out.q.z(), 1e-12);
+
+    put_i16_be(frame + 4, 1234);
+    put_i16_be(frame + 6, -456);
+    put_i16_be(frame + 8, 789);
+    decode(decode_100s_euler, 0x16, out);
+    expect_quaternion(rotation(123.4f * deg, Z, -45.6f * deg, Y, 78.9f * deg, X), out.q);
+}
+
+TEST_P(FrameDecode, Model100SImu)
+{
+    const int16_t raw[9] = {16384, -8192, 1000, 328, -656, 1, -300, 200, -100};
+    for (int i = 0; i < 9; ++i)
+        put_i16_be(frame + 4 + 2 * i, raw[i]);
+    ImuFrame out;
+    decode(decode_100s_imu, 0x18, out);
+    EXPECT_EQ(1.0f * 9.81, out.a.x());
+    EXPECT_EQ(-0.5f * 9.81, out.a.y());
+    EXPECT_EQ(1000 / 16384.0f * 9.81, out.a.z());
+    EXPECT_EQ(328 / 32.8f, out.w.x());
+    EXPECT_EQ(-656 / 32.8f, out.w.y());
+    EXPECT_EQ(1 / 32.8f, out.w.z());
+    EXPECT_EQ(Eigen::Vector3d(-300, 200, -100), out.mag);
+}
+
+TEST_P(FrameDecode, Model100SGps)
+{
+    put_i32_be(frame + 4, 31234567);
+    put_i32_be(frame + 8, 121765432);
+    put_i16_be(frame + 16, -123);
+    const uint8_t hemisphere[4] = {0x22, 0x12, 0x11, 0x21};
+    const double lat_sign[4] = {1, -1, -1, 1};
+    const double lon_sign[4] = {1, 1, -1, -1};
+    for (int i = 0; i < 4; ++i)
+    {
+        frame[18] = hemisphere[i];
+        double latitude, longitude, altitude;
+        decode_100s_gps(frame, latitude, longitude, altitude);
+        EXPECT_EQ(lat_sign[i] * (31234567 * 1e-6), latitude);
+        EXPECT_EQ(lon_sign[i] * (121765432 * 1e-6), longitude);
+        // 海拔保持原驱动的读法: 16..19 四字节，两半以8位移位合并
+        EXPECT_EQ((double)((0xFF85 << 8) | (hemisphere[i] << 8)) / 10.0f, altitude);
+    }
+}
+
+TEST_P(FrameDecode, Model100D2)
+{
+    const int16_t raw[12] = {900, 0, 0, 16384, 8192, -16384, 328, -328, 656, 11, -22, 33};
+    for (int i = 0; i < 12; ++i)
+        put_i16_be(frame + 3 + 2 * i, raw[i]);
+    ImuFrame out;
+    decode(decode_100d2, 40, out);
+    // 航向取反: 90 度变成绕Z -90 度
+    EXPECT_NEAR(sqrt(0.5), out.q.w(), 1e-12);
+    EXPECT_NEAR(0.0, out.q.x(), 1e-12);
+    EXPECT_NEAR(0.0, out.q.y(), 1e-12);
+    EXPECT_NEAR(-sqrt(0.5), out.q.z(), 1e-12);
+    EXPECT_EQ(Eigen::Vector3d(1.0 * 9.81, 0.5 * 9.81, -1.0 * 9.81), out.a);
+    EXPECT_EQ(Eigen::Vector3d(10, -10, 20), out.w);
+    EXPECT_EQ(Eigen::Vector3d(11, -22, 33), out.mag);
+
+    // 字段顺序 航向、横滚、俯仰，按 Z(-航向) Y(俯仰) X(横滚) 组合
+    put_i16_be(frame + 3, 1234);
+    put_i16_be(frame + 5, -567);
+    put_i16_be(frame + 7, 89);
+    decode(decode_100d2, 40, out);
+    expect_quaternion(rotation(-123.4f * deg, Z, 8.9f * deg, Y, -56.7f * deg, X), out.q);
+}
+
+static void put_a_fields(uint8_t *frame, const float *euler)
+{
+    const float fields[9] = {1000.0f, -500.0f, 250.0f, 90.0f, -45.0f, 1.5f, 0.25f, -0.5f, 0.75f};
+    for (int i = 0; i < 9; ++i)
+        put_f32(frame + 3 + 4 * i, fields[i]);
+    for (int i = 0; i < 3; ++i)
+        put_f32(frame + 39 + 4 * i, euler[i]);
+}
+
+static void expect_a_fields(const ImuFrame &out)
+{
+    EXPECT_EQ(1000.0f * 1e-3 * 9.81, out.a.x());
+    EXPECT_EQ(-500.0f * 1e-3 * 9.81, out.a.y());
+    EXPECT_EQ(250.0f * 1e-3 * 9.81, out.a.z());
+    EXPECT_EQ(90.0f * M_PI / 180, out.w.x());
+    EXPECT_EQ(-45.0f * M_PI / 180, out.w.y());
+    EXPECT_EQ(1.5f * M_PI / 180, out.w.z());
+    EXPECT_EQ(Eigen::Vector3d(0.25, -0.5, 0.75), out.mag);
+}
+
+TEST_P(FrameDecode, Model200A)
+{
+    const float euler[3] = {30.0f, -20.0f, 10.0f};
+    put_a_fields(frame, euler);
+    ImuFrame out;
+    decode(decode_200a, 61, out);
+    expect_a_fields(out);
+    expect_quaternion(rotation(30.0f * deg, Z, -20.0f * deg, Y, 10.0f * deg, X), out.q);
+}
+
+TEST_P(FrameDecode, Model300A)
+{
+    // 后两个欧拉角取反
+    const float euler[3] = {0.0f, 30.0f, 0.0f};
+    put_a_fields(frame, euler);
+    ImuFrame out;
+    decode(decode_300a, 61, out);
+    expect_a_fields(out);
+    EXPECT_NEAR(cos(15 * deg), out.q.w(), 1e-12);
+    EXPECT_NEAR(-sin(15 * deg), out.q.x(), 1e-12);
+    EXPECT_NEAR(0.0, out.q.y(), 1e-12);
+    EXPECT_NEAR(0.0, out.q.z(), 1e-12);
+
+    const float euler2[3] = {30.0f, -20.0f, 10.0f};
+    put_a_fields(frame, euler2);
+    decode(decode_300a, 61, out);
+    expect_quaternion(rotation(30.0f * deg, Y, 20.0f * deg, X, -10.0f * deg, Z), out.q);
+}
+
+TEST_P(FrameDecode, Model200S)
+{
+    // 加速度 Y X Z、角速度 Y X Z、温度，两组的Y取反
+    const int16_t raw[7] = {2000, -1000, 4000, 500, -250, 100, 2512};
+    for (int i = 0; i < 7; ++i)
+        put_i16_le(frame + 3 + 2 * i, raw[i]);
+    // 俯仰(取反)、横滚、航向(取反)
+    put_f32(frame + 17, 10.0f);
+    put_f32(frame + 21, 20.0f);
+    put_f32(frame + 25, 30.0f);
+    // 磁场 Y X Z，Y取反
+    put_i16_le(frame + 70, 300);
+    put_i16_le(frame + 72, -200);
+    put_i16_le(frame + 74, 100);
+
+    ImuFrame out;
+    decode(decode_200s, 92, out);
+    EXPECT_EQ(-1000.0f * 0.5 * 1e-3 * 9.81, out.a.x());
+    EXPECT_EQ(-2000.0f * 0.5 * 1e-3 * 9.81, out.a.y());
+    EXPECT_EQ(4000.0f * 0.5 * 1e-3 * 9.81, out.a.z());
+    EXPECT_EQ(-250.0f * 0.02 * M_PI / 180, out.w.x());
+    EXPECT_EQ(-500.0f * 0.02 * M_PI / 180, out.w.y());
+    EXPECT_EQ(100.0f * 0.02 * M_PI / 180, out.w.z());
+    EXPECT_EQ(Eigen::Vector3d(-200, -300, 100), out.mag);
+    expect_quaternion(rotation(-30.0f * deg, Z, -10.0f * deg, Y, 20.0f * deg, X), out.q);
+
+    put_f64(frame + 35, 121.5);
+    put_f64(frame + 43, -31.25);
+    put_f32(frame + 51, 12.5f);
+    double latitude, longitude, altitude;
+    decode_200s_gps(frame, latitude, longitude, altitude);
+    EXPECT_EQ(-31.25, latitude);
+    EXPECT_EQ(121.5, longitude);
+    EXPECT_EQ(12.5, altitude);
+}
+
+#ifdef __SSE2__
+INSTANTIATE_TEST_CASE_P(Kernels, FrameDecode, testing::Values("scalar", "sse2"));
+#else
+INSTANTIATE_TEST_CASE_P(Kernels, FrameDecode, testing::Values("scalar"));
+#endif
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
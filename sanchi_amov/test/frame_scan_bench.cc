@@ -0,0 +1,37 @@
+// 帧头查找+校验的吞吐量: 每次处理一个 92 字节、不含帧头的 200S 大小数据块
+// 用法: frame_scan_bench [次数]
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+#include "../src/frame_scan.h"
+
+int main(int argc, char **argv)
+{
+    long rounds = argc > 1 ? atol(argv[1]) : 5000000;
+    std::vector<uint8_t> buf(200);
+    srand(1);
+    for (size_t i = 0; i < buf.size(); ++i)
+        buf[i] = rand() & 0x3f;
+
+    const char *names[] = {"scalar", "sse2", "avx2"};
+    for (int n = 0; n < 3; ++n)
+    {
+        if (!select_frame_kernels(names[n]))
+        {
+            printf("%-6s not supported\n", names[n]);
+            continue;
+        }
+        volatile long acc = 0;
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        for (long r = 0; r < rounds; ++r)
+        {
+            buf[r % 8] ^= 1;
+            int k = find_header(buf.data(), 0, 92, 0x55, 0xAA);
+            acc += k + byte_sum(buf.data() + 2, 88);
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / rounds;
+        printf("%-6s %6.1f ns/chunk\n", names[n], ns);
+    }
+    return 0;
+}
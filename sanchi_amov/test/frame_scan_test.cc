@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <vector>
+#include "../src/frame_scan.h"
+
+// 逐字节的参考实现，各 SIMD 实现必须与之完全一致
+static int ref_find_header(const uint8_t *buf, int from, int len, uint8_t h0, uint8_t h1)
+{
+    for (int i = from; i < len - 1; ++i)
+    {
+        if (buf[i] == h0 && buf[i + 1] == h1)
+            return i;
+    }
+    return len;
+}
+
+static uint32_t ref_byte_sum(const uint8_t *buf, int len)
+{
+    uint32_t sum = 0;
+    for (int i = 0; i < len; ++i)
+        sum += buf[i];
+    return sum;
+}
+
+static void check_kernels(const char *name)
+{
+    if (!select_frame_kernels(name))
+    {
+        printf("%s not supported on this CPU, skipped\n", name);
+        return;
+    }
+    srand(1);
+    for (int t = 0; t < 200000; ++t)
+    {
+        // 帧头字节出现得足够频繁，覆盖跨16/32字节边界和半个帧头在末尾的情况
+        int len = rand() % 200;
+        std::vector<uint8_t> buf(len + 1);
+        for (size_t i = 0; i < buf.size(); ++i)
+            buf[i] = rand() % 4 == 0 ? (rand() % 2 ? 0x55 : 0xAA) : rand();
+        int from = len ? rand() % (len + 1) : 0;
+        ASSERT_EQ(ref_find_header(buf.data(), from, len, 0x55, 0xAA),
+                  find_header(buf.data(), from, len, 0x55, 0xAA))
+            << name << " len " << len << " from " << from;
+        ASSERT_EQ(ref_byte_sum(buf.data() + from, len - from),
+                  byte_sum(buf.data() + from, len - from))
+            << name << " len " << len << " from " << from;
+    }
+}
+
+TEST(FrameScan, Scalar)
+{
+    check_kernels("scalar");
+}
+
+TEST(FrameScan, Sse2)
+{
+    check_kernels("sse2");
+}
+
+TEST(FrameScan, Avx2)
+{
+    check_kernels("avx2");
+}
+
+// 全 0xFF 时 byte_sum 的中间累加不能溢出
+TEST(FrameScan, ByteSumLarge)
+{
+    std::vector<uint8_t> buf(4096, 0xFF);
+    const char *names[] = {"scalar", "sse2", "avx2"};
+    for (int n = 0; n < 3; ++n)
+    {
+        if (!select_frame_kernels(names[n]))
+            continue;
+        for (int len = 4000; len <= 4096; ++len)
+            ASSERT_EQ(255u * len, byte_sum(buf.data(), len)) << names[n];
+    }
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
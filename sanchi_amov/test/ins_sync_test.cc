@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <vector>
+#include "../src/ins_sync.h"
+
+// 100Hz、绕Z 0.1rad/s 匀速转动、比力恒定的IMU
+static ImuSample yaw_sample(int i)
+{
+    ImuSample s;
+    s.t = 100.0 + i * 0.01;
+    s.q = Eigen::Quaterniond(Eigen::AngleAxisd(0.1 * i * 0.01, Eigen::Vector3d::UnitZ()));
+    s.w = Eigen::Vector3d(0, 0, 0.1);
+    s.a = Eigen::Vector3d(0, 0, 9.81);
+    return s;
+}
+
+// 每个历元的角度增量应为 0.1*delta_time，比力与转轴平行，速度增量为 9.81*delta_time
+static void expect_consistent(const InsState &state)
+{
+    EXPECT_NEAR(0.1 * state.delta_time, state.delta_angle.z(), 1e-9);
+    EXPECT_NEAR(0.0, state.delta_angle.head<2>().norm(), 1e-9);
+    EXPECT_NEAR(9.81 * state.delta_time, state.delta_velocity.z(), 1e-9);
+    EXPECT_NEAR(0.0, state.delta_velocity.head<2>().norm(), 1e-9);
+}
+
+// 位置30秒不变: 每 max_interval 补一个 repeated 历元，增量和 delta_time 对应
+TEST(InsSync, Stationary)
+{
+    InsSync sync(0.0, 1.0);
+    std::vector<InsState, Eigen::aligned_allocator<InsState> > epochs;
+    for (int i = 0; i <= 3000; ++i)
+    {
+        InsState state;
+        if (sync.push(yaw_sample(i), 31.0, 121.0, 10.0, state))
+            epochs.push_back(state);
+    }
+    ASSERT_EQ(31u, epochs.size());
+    EXPECT_EQ(0.0, epochs[0].delta_time);
+    EXPECT_FALSE(epochs[0].repeated);
+    double total = 0;
+    for (size_t k = 1; k < epochs.size(); ++k)
+    {
+        EXPECT_TRUE(epochs[k].repeated);
+        EXPECT_NEAR(1.0, epochs[k].delta_time, 0.011);
+        EXPECT_NEAR(epochs[k - 1].t + epochs[k].delta_time, epochs[k].t, 1e-9);
+        expect_consistent(epochs[k]);
+        total += epochs[k].delta_time;
+    }
+    EXPECT_NEAR(30.0, total, 0.011);
+}
+
+// 默认补发间隔为5秒
+TEST(InsSync, StationaryDefault)
+{
+    InsSync sync;
+    int count = 0;
+    for (int i = 0; i <= 3000; ++i)
+    {
+        InsState state;
+        if (sync.push(yaw_sample(i), 31.0, 121.0, 10.0, state) && count++ > 0)
+        {
+            EXPECT_NEAR(5.0, state.delta_time, 0.011);
+            expect_consistent(state);
+        }
+    }
+    EXPECT_EQ(7, count);
+}
+
+// 1Hz 的GPS，更新时刻有 ±2 个采样的抖动: 每个历元都是新定位，位置与历元对应，
+// 不能插入带旧位置的补发历元，也不能把一个周期拆成很短的两段
+TEST(InsSync, Moving1HzJitter)
+{
+    InsSync sync;
+    srand(1);
+    int next = 100, fixes = 0, count = 0;
+    double lat = 31.0, last_lat = 0;
+    for (int i = 0; i <= 6000; ++i)
+    {
+        if (i == next)
+        {
+            lat += 1e-5;
+            ++fixes;
+            next = 100 * (fixes + 1) + rand() % 5 - 2;
+        }
+        InsState state;
+        if (!sync.push(yaw_sample(i), lat, 121.0, 10.0, state))
+            continue;
+        EXPECT_FALSE(state.repeated);
+        EXPECT_NE(last_lat, state.latitude);
+        last_lat = state.latitude;
+        if (count++ > 0)
+        {
+            EXPECT_NEAR(1.0, state.delta_time, 0.041);
+            expect_consistent(state);
+        }
+    }
+    EXPECT_EQ(fixes + 1, count);
+}
+
+// 10Hz 的GPS按位置变化检测历元，静止补发不应插入额外历元
+TEST(InsSync, Moving)
+{
+    InsSync sync(0.0, 1.0);
+    int count = 0;
+    for (int i = 0; i <= 1000; ++i)
+    {
+        double lat = 31.0 + 1e-6 * (i / 10);
+        InsState state;
+        if (!sync.push(yaw_sample(i), lat, 121.0, 10.0, state))
+            continue;
+        if (count++ > 0)
+        {
+            EXPECT_NEAR(0.1, state.delta_time, 1e-9);
+            expect_consistent(state);
+        }
+    }
+    EXPECT_EQ(101, count);
+}
+
+// GPS 延时: 历元落在两个IMU采样之间，插值姿态应对应历元时刻
+TEST(InsSync, Delay)
+{
+    InsSync sync(0.025, 1.0);
+    std::vector<InsState, Eigen::aligned_allocator<InsState> > epochs;
+    for (int i = 0; i <= 500; ++i)
+    {
+        InsState state;
+        if (sync.push(yaw_sample(i), 31.0 + 1e-6 * (i / 10), 121.0, 10.0, state))
+            epochs.push_back(state);
+    }
+    ASSERT_GT(epochs.size(), 2u);
+    for (size_t k = 1; k < epochs.size(); ++k)
+    {
+        const InsState &e = epochs[k];
+        Eigen::AngleAxisd aa(e.imu.q);
+        EXPECT_NEAR(0.1 * (e.t - 100.0), aa.angle(), 1e-9);
+        expect_consistent(e);
+    }
+}
+
+// GPS 短时丢失: 回来后补上整段增量
+TEST(InsSync, ShortOutage)
+{
+    InsSync sync(0.0, 1.0);
+    InsState state;
+    ASSERT_TRUE(sync.push(yaw_sample(0), 31.0, 121.0, 10.0, state));
+    for (int i = 1; i < 500; ++i)
+        EXPECT_FALSE(sync.push(yaw_sample(i), 0, 0, 0, state));
+    ASSERT_TRUE(sync.push(yaw_sample(500), 31.0, 121.0, 10.0, state));
+    EXPECT_TRUE(state.repeated);
+    EXPECT_NEAR(5.0, state.delta_time, 1e-9);
+    expect_consistent(state);
+}
+
+// GPS 丢失超过IMU缓存: 不能发布残缺区间的增量，从零重新开始
+TEST(InsSync, LongOutage)
+{
+    InsSync sync(0.0, 1.0);
+    InsState state;
+    ASSERT_TRUE(sync.push(yaw_sample(0), 31.0, 121.0, 10.0, state));
+    for (int i = 1; i < 3000; ++i)
+        EXPECT_FALSE(sync.push(yaw_sample(i), 0, 0, 0, state));
+    ASSERT_TRUE(sync.push(yaw_sample(3000), 31.0, 121.0, 10.0, state));
+    EXPECT_EQ(0.0, state.delta_time);
+    EXPECT_EQ(Eigen::Vector3d::Zero(), state.delta_angle);
+    EXPECT_EQ(Eigen::Vector3d::Zero(), state.delta_velocity);
+
+    ASSERT_FALSE(sync.push(yaw_sample(3001), 31.0, 121.0, 10.0, state));
+    for (int i = 3002; i <= 3100; ++i)
+    {
+        if (sync.push(yaw_sample(i), 31.0, 121.0, 10.0, state))
+        {
+            EXPECT_NEAR(1.0, state.delta_time, 1e-9);
+            expect_consistent(state);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}